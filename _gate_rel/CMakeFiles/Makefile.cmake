@@ -0,0 +1,71 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/extras/host/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceRuns.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFileCXX.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceRuns.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "extras/host/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "extras/host/CMakeFiles/HostSimulation.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/MailboxStress.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/ParallelStep.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/Benchmark.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/BenchmarkNoSIMD.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/Accuracy.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/StepperPulses.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/JerkLimit.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/GroupSync.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/BankMatch.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/BankMatchNoSIMD.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/BankMatchAVX2.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/TimeToTarget.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/WaypointPath.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/ProfileFollow.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/FixedMatch.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/FixedRateMatch.dir/DependInfo.cmake"
+  "extras/host/CMakeFiles/GenerateMatch.dir/DependInfo.cmake"
+  )
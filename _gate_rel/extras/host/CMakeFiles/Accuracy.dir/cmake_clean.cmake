@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "Accuracy"
+  "Accuracy.pdb"
+  "CMakeFiles/Accuracy.dir/Accuracy.cpp.o"
+  "CMakeFiles/Accuracy.dir/Accuracy.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Accuracy.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
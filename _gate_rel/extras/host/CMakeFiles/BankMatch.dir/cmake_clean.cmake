@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BankMatch"
+  "BankMatch.pdb"
+  "CMakeFiles/BankMatch.dir/BankMatch.cpp.o"
+  "CMakeFiles/BankMatch.dir/BankMatch.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BankMatch.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
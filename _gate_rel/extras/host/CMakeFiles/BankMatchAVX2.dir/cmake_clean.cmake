@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BankMatchAVX2"
+  "BankMatchAVX2.pdb"
+  "CMakeFiles/BankMatchAVX2.dir/BankMatch.cpp.o"
+  "CMakeFiles/BankMatchAVX2.dir/BankMatch.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BankMatchAVX2.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BankMatchNoSIMD"
+  "BankMatchNoSIMD.pdb"
+  "CMakeFiles/BankMatchNoSIMD.dir/BankMatch.cpp.o"
+  "CMakeFiles/BankMatchNoSIMD.dir/BankMatch.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BankMatchNoSIMD.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
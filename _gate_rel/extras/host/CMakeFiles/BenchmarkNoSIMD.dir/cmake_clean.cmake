@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BenchmarkNoSIMD"
+  "BenchmarkNoSIMD.pdb"
+  "CMakeFiles/BenchmarkNoSIMD.dir/Benchmark.cpp.o"
+  "CMakeFiles/BenchmarkNoSIMD.dir/Benchmark.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BenchmarkNoSIMD.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FixedMatch.dir/FixedMatch.cpp.o"
+  "CMakeFiles/FixedMatch.dir/FixedMatch.cpp.o.d"
+  "FixedMatch"
+  "FixedMatch.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FixedMatch.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FixedRateMatch.dir/FixedRateMatch.cpp.o"
+  "CMakeFiles/FixedRateMatch.dir/FixedRateMatch.cpp.o.d"
+  "FixedRateMatch"
+  "FixedRateMatch.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FixedRateMatch.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/GenerateMatch.dir/GenerateMatch.cpp.o"
+  "CMakeFiles/GenerateMatch.dir/GenerateMatch.cpp.o.d"
+  "GenerateMatch"
+  "GenerateMatch.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/GenerateMatch.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
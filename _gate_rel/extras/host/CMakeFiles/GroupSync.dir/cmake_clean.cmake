@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/GroupSync.dir/GroupSync.cpp.o"
+  "CMakeFiles/GroupSync.dir/GroupSync.cpp.o.d"
+  "GroupSync"
+  "GroupSync.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/GroupSync.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/HostSimulation.dir/HostSimulation.cpp.o"
+  "CMakeFiles/HostSimulation.dir/HostSimulation.cpp.o.d"
+  "HostSimulation"
+  "HostSimulation.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/HostSimulation.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
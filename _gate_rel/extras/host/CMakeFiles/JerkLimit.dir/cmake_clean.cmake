@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/JerkLimit.dir/JerkLimit.cpp.o"
+  "CMakeFiles/JerkLimit.dir/JerkLimit.cpp.o.d"
+  "JerkLimit"
+  "JerkLimit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/JerkLimit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MailboxStress.dir/MailboxStress.cpp.o"
+  "CMakeFiles/MailboxStress.dir/MailboxStress.cpp.o.d"
+  "MailboxStress"
+  "MailboxStress.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MailboxStress.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
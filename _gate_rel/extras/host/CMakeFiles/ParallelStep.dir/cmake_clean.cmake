@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ParallelStep.dir/ParallelStep.cpp.o"
+  "CMakeFiles/ParallelStep.dir/ParallelStep.cpp.o.d"
+  "ParallelStep"
+  "ParallelStep.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ParallelStep.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
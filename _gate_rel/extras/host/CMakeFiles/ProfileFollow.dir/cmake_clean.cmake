@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ProfileFollow.dir/ProfileFollow.cpp.o"
+  "CMakeFiles/ProfileFollow.dir/ProfileFollow.cpp.o.d"
+  "ProfileFollow"
+  "ProfileFollow.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ProfileFollow.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/StepperPulses.dir/StepperPulses.cpp.o"
+  "CMakeFiles/StepperPulses.dir/StepperPulses.cpp.o.d"
+  "StepperPulses"
+  "StepperPulses.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/StepperPulses.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
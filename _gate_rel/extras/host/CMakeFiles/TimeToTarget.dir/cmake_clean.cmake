@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/TimeToTarget.dir/TimeToTarget.cpp.o"
+  "CMakeFiles/TimeToTarget.dir/TimeToTarget.cpp.o.d"
+  "TimeToTarget"
+  "TimeToTarget.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/TimeToTarget.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/WaypointPath.dir/WaypointPath.cpp.o"
+  "CMakeFiles/WaypointPath.dir/WaypointPath.cpp.o.d"
+  "WaypointPath"
+  "WaypointPath.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/WaypointPath.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -9,11 +9,19 @@
  */
 #include <Arduino.h>
 #include <Derivs_Limiter.h>
+#include <Derivs_Limiter_Mailbox.h>
+#include <Derivs_Limiter_Profile.h>
 // Velocity and/or acceleration limits can be set as INFINITY in order to have no limit.
 
 //    Derivs_Limiter(float _velLimit, float _accelLimit, float _decelLimit = NAN, float _target = 0, float _startPos = 0, float _startVel = 0, bool _preventGoingWrongWay = false, bool _preventGoingTooFast = false, float _posLimitLow = -INFINITY, float _posLimitHigh = INFINITY, float _maxStoppingDecel = 2, float* _posPointer = NULL, float* _velPointer = NULL)
 
-Derivs_Limiter limiter = Derivs_Limiter(10, 5, NAN, 0, 0, 0, false, false, -INFINITY, INFINITY, 2, NULL, NULL);
+// Derivs_Limiter leaves some features out unless they're asked for, see Derivs_Limiter_Features. This one has every feature so that every function does something.
+typedef Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Features<true, true, true, true, false, true, true, true, true> > Limiter;
+
+Limiter limiter = Limiter(10, 5, NAN, 0, 0, 0, false, false, -INFINITY, INFINITY, 2, NULL, NULL);
+
+Derivs_Limiter_Profile profile;
+Derivs_Limiter_Mailbox mailbox;
 
 void setup()
 {
@@ -23,6 +31,8 @@ void setup()
     limiter.setVelLimit(10);
     limiter.setAccelLimit(5);
     limiter.setDecelLimit(NAN);
+    limiter.setJerkLimit(INFINITY); // how fast acceleration can change, INFINITY for no limit
+    limiter.setMaxSubStep(INFINITY); // split longer time intervals into sub-steps this long (seconds), INFINITY to not split
     limiter.setTarget(0);
     limiter.setPosition(0);
     limiter.setVelocity(0);
@@ -55,6 +65,8 @@ void setup()
     limiter.getVelLimit();
     limiter.getAccelLimit();
     limiter.getDecelLimit();
+    limiter.getJerkLimit();
+    limiter.getMaxSubStep();
     limiter.getMaxStoppingDecel();
     limiter.getLowPosLimit();
     limiter.getHighPosLimit();
@@ -74,6 +86,11 @@ void setup()
     limiter.isPosAtTarget();
     limiter.isPosNotAtTarget();
     limiter.distToTarget();
+    limiter.getTimeToTarget(); // seconds until position reaches target and stops, calculated without running calc()
+    limiter.getTimeToStop(); // seconds to slow down to a stop
+    limiter.isIdle(); // true if calc() won't change anything until something is set
+    limiter.getTimeToNextEvent(); // seconds until acceleration ends, deceleration starts, or position arrives
+    limiter.getNextEventTime(); // the same, as a micros() time
 
     // velocity mode
 
@@ -87,7 +104,28 @@ void setup()
     limiter.setVelLimitForTimedMove(20, 5, NAN); // dist, time, maxVel
     limiter.setTargetAndVelLimitForTimedMove(10, 5, NAN); // target, time, maxVel
     limiter.setTargetTimedMovePreferred(10, 5, NAN); // target, time, maxVel
+    limiter.getMinTimeForMove(20, NAN); // dist, maxVel, shortest time a timed move can take
     limiter.resetVelLimitToOriginal();
+
+    // precomputed profile
+
+    limiter.setProfile(&profile); // each new target is reached by following a trapezoidal profile that's solved once, NULL to stop using it
+    profile.getDuration(); // seconds the current move takes
+    profile.isActive(); // false once the move is done, or if it was changed during the move
+    float pos, vel, acc;
+    profile.evaluate(0.5, pos, vel, acc); // position, velocity and acceleration 0.5 seconds after the move started
+    profile.plan(0, 0, 10, 10, 5, 5); // profiles can also be used alone: startPos, startVel, target, velLimit, accelLimit, decelLimit
+    limiter.setProfile(NULL);
+
+    // commands from another thread, core, or interrupt
+
+    limiter.setMailbox(&mailbox); // NULL to stop using it
+    mailbox.postTarget(10, 5, 2, NAN); // target, velLimit, accelLimit, decelLimit (NAN = don't change), call from the other thread, applied together at the start of the next calc()
+    Derivs_Limiter_Command command; // every value starts as NAN (don't change)
+    command.velTarget = 1;
+    mailbox.post(command);
+    mailbox.isPending(); // true until the limiter takes the command
+    limiter.applyCommand(command); // makes the same changes right away
 }
 
 void loop()
@@ -97,5 +135,15 @@ void loop()
 
     limiter.calc(10); // calc but first set target
 
+    limiter.step(0.01); // calc for a time interval in seconds that you give instead of reading micros()
+
+    limiter.calc(10, 0.01); // step() but first set target
+
+    float positions[10];
+    float velocities[10];
+    limiter.generate(positions, velocities, 10, 0.001); // runs step(0.001) 10 times and fills the arrays (either can be NULL), continues where the last call stopped
+    float interleaved[20];
+    limiter.generate(interleaved, interleaved + 1, 10, 0.001, 2); // stride: write every 2nd value, position and velocity alternate
+
     // calc() should be run as frequently and regularly as possible, though it doesn't need to be run on a strict timer
 }
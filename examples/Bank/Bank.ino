@@ -0,0 +1,43 @@
+/*
+    This example does the same thing as the Multi example, but with a Derivs_Limiter_Bank,
+    which stores every channel's values in arrays and calculates all of them with one reading of micros().
+    Use a bank when there are many channels, it uses less memory and time per channel than an array of Derivs_Limiters.
+    Tested on an Arduino Uno but should work on anything.
+*/
+#include <Arduino.h>
+#include <Derivs_Limiter_Bank.h> // https://github.com/joshua-8/Derivs_Limiter
+
+const int NUM_DLs = 4; // limited only by the Arduino's memory and the time it takes to compute each channel
+
+Derivs_Limiter_Bank<NUM_DLs> bank;
+
+// random settings just as an example of each channel getting unique settings
+float velLimit[NUM_DLs] = { 150, 222.2, 122, 160 };
+float accLimit[NUM_DLs] = { 270, 245.5, 250, 340 };
+
+void setup()
+{
+    Serial.begin(115200);
+    for (int i = 0; i < NUM_DLs; i++) {
+        bank.setVelAccelLimits(i, velLimit[i], accLimit[i]);
+        // now is a good place to set other settings for each channel
+    }
+}
+
+void loop()
+{
+    for (int i = 0; i < NUM_DLs; i++) {
+        float targ = ((millis() % (500 + 100 * i)) < (500 + 100 * i) / 2) ? -(i + 1) : (i + 1); // targets are set to be -(i+1) or (i+1) on an interval that is unique for each channel
+        bank.setTarget(i, targ); // you could give each channel any target you want it to go to
+    }
+
+    bank.calc(); // calculates every channel
+
+    for (int i = 0; i < NUM_DLs; i++) {
+        Serial.print(bank.getPosition(i)); // bank.getPosition(i) is the value that could be sent to the i numbered servo
+        if (i < NUM_DLs - 1) // add commas between numbers, a newline at the end
+            Serial.print(", ");
+        else
+            Serial.println();
+    }
+}
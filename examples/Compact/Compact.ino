@@ -0,0 +1,49 @@
+/*
+    This example does the same thing as the Multi example, but with Derivs_Limiter_Compacts,
+    which only store position, velocity, target, and a pointer to limits that channels share.
+    Use them when memory is short, an Arduino Uno has room for many more of them than of Derivs_Limiters.
+    Tested on an Arduino Uno but should work on anything.
+*/
+#include <Arduino.h>
+#include <Derivs_Limiter_Compact.h> // https://github.com/joshua-8/Derivs_Limiter
+
+const int NUM_DLs = 16; // limited only by the Arduino's memory and the time it takes to compute each channel
+
+// channels share these two sets of limits, changing one changes every channel that uses it
+Derivs_Limiter_Shared_Limits slow = Derivs_Limiter_Shared_Limits(150, 270); // velLimit, accelLimit
+Derivs_Limiter_Shared_Limits fast = Derivs_Limiter_Shared_Limits(222.2, 545.5);
+
+Derivs_Limiter_Compact DL[NUM_DLs];
+
+unsigned long lastMicros = 0;
+
+void setup()
+{
+    Serial.begin(115200);
+    for (int i = 0; i < NUM_DLs; i++) {
+        DL[i].setLimits((i % 2 == 0) ? &slow : &fast);
+    }
+    Serial.print("bytes per channel: ");
+    Serial.println(sizeof(Derivs_Limiter_Compact));
+    lastMicros = micros();
+}
+
+void loop()
+{
+    unsigned long now = micros();
+    float dt = (now - lastMicros) / 1000000.0; // read the clock once for every channel
+    lastMicros = now;
+
+    for (int i = 0; i < NUM_DLs; i++) {
+        float targ = ((millis() % (500 + 100 * i)) < (500 + 100 * i) / 2) ? -(i + 1) : (i + 1); // targets are set to be -(i+1) or (i+1) on an interval that is unique for each channel
+        DL[i].setTarget(targ);
+
+        DL[i].step(dt);
+
+        Serial.print(DL[i].getPosition());
+        if (i < NUM_DLs - 1) // add commas between numbers, a newline at the end
+            Serial.print(", ");
+        else
+            Serial.println();
+    }
+}
@@ -0,0 +1,30 @@
+/**
+ * FixedPoint, an example for the Derivs_Limiter library
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * The SmoothServo example using Derivs_Limiter_Fixed, which calculates with integers only.
+ * This is faster on boards without a floating point unit, like the Arduino Uno.
+ * Values are Q16.16 fixed point: DL_FIXED(x) converts a constant, >> 16 gives whole units.
+ *
+ * Connect a servo to power and pin 9.
+ */
+#include <Arduino.h>
+#include <Derivs_Limiter_Fixed.h>
+#include <Servo.h>
+
+Derivs_Limiter_Fixed limiter = Derivs_Limiter_Fixed(DL_FIXED(100), DL_FIXED(100), DL_FIXED(50)); // velocityLimit, accelerationLimit, decelerationLimit
+Servo myServo;
+void setup()
+{
+    myServo.attach(9);
+}
+void loop()
+{
+    if (millis() % 10000 < 5000) { // toggles every 5 seconds
+        limiter.setTarget(DL_FIXED(0));
+    } else {
+        limiter.setTarget(DL_FIXED(180));
+    }
+    myServo.write(limiter.calc() >> 16);
+    delay(25);
+}
@@ -0,0 +1,61 @@
+/**
+ * FixedRate, an example for the Derivs_Limiter library
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * The SmoothServo example using Derivs_Limiter_Fixed_Rate, calculated 1000 times a second from a timer interrupt.
+ * The loop doesn't have to run at any particular rate, it gives targets to the interrupt through a Derivs_Limiter_Mailbox.
+ * On an Arduino Uno this uses Timer2 (the Servo library uses Timer1), on other boards tick() is called from the loop instead.
+ *
+ * Connect a servo to power and pin 9.
+ */
+#include <Arduino.h>
+#include <Derivs_Limiter_Fixed_Rate.h>
+#include <Servo.h>
+
+Derivs_Limiter_Fixed_Rate limiter = Derivs_Limiter_Fixed_Rate(0.001, 100, 100, 50); // timestep (seconds, matches the timer), velocityLimit, accelerationLimit, decelerationLimit
+Derivs_Limiter_Mailbox mailbox; // so the loop never changes the limiter in the middle of tick()
+Servo myServo;
+
+#if defined(__AVR_ATmega328P__)
+ISR(TIMER2_COMPA_vect)
+{
+    limiter.tick();
+}
+#endif
+
+void setup()
+{
+    myServo.attach(9);
+    limiter.setMailbox(&mailbox);
+#if defined(__AVR_ATmega328P__)
+    noInterrupts();
+    TCCR2A = _BV(WGM21); // CTC mode
+    TCCR2B = _BV(CS22); // 16 MHz / 64
+    OCR2A = 249; // / 250 = 1 kHz
+    TIMSK2 = _BV(OCIE2A);
+    interrupts();
+#endif
+}
+
+void loop()
+{
+    static float lastTarget = NAN;
+    float target = (millis() % 10000 < 5000) ? 0 : 180; // toggles every 5 seconds
+    if (target != lastTarget) {
+        mailbox.postTarget(target);
+        lastTarget = target;
+    }
+
+#if !defined(__AVR_ATmega328P__)
+    static unsigned long lastTick = micros();
+    while (micros() - lastTick >= 1000) {
+        lastTick += 1000;
+        limiter.tick();
+    }
+#endif
+
+    noInterrupts(); // a float can't be read in one instruction on an Uno
+    float position = limiter.getPosition();
+    interrupts();
+    myServo.write(position);
+}
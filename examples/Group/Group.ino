@@ -0,0 +1,36 @@
+/*
+    This example moves two axes (like the X and Y of a plotter or pick and place machine) so they always start and finish moves together,
+    even though the distances and limits of the axes are different. Every two seconds a new random point is picked.
+    Open the Serial Plotter to see the positions.
+    Tested on an Arduino Uno but should work on anything.
+*/
+#include <Arduino.h>
+#include <Derivs_Limiter_Group.h> // https://github.com/joshua-8/Derivs_Limiter
+
+Derivs_Limiter xAxis = Derivs_Limiter(200, 400); // velLimit, accelLimit
+Derivs_Limiter yAxis = Derivs_Limiter(100, 150);
+
+Derivs_Limiter* axes[2] = { &xAxis, &yAxis };
+Derivs_Limiter_Group<2> group = Derivs_Limiter_Group<2>(axes);
+
+unsigned long lastMoveMillis = 0;
+
+void setup()
+{
+    Serial.begin(115200);
+}
+
+void loop()
+{
+    if (millis() - lastMoveMillis > 2000) {
+        lastMoveMillis = millis();
+        float targets[2] = { (float)random(0, 300), (float)random(0, 300) };
+        group.setTargets(targets); // returns how many seconds the move will take
+    }
+
+    group.calc(); // runs calc() on both axes
+
+    Serial.print(xAxis.getPosition());
+    Serial.print(", ");
+    Serial.println(yAxis.getPosition());
+}
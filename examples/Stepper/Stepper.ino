@@ -0,0 +1,64 @@
+/**
+ * Stepper, an example for the Derivs_Limiter library
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Drives a stepper motor driver (step and direction pins) with Derivs_Limiter_Stepper.
+ * The loop calculates the move ahead of time and queues the time of each step, a timer interrupt at 20 kHz takes them and pulses the step pin.
+ * Position is in revolutions of a motor with 200 steps per revolution.
+ * This example uses Timer2 of an Arduino Uno, other boards need their own timer setup.
+ *
+ * Connect the driver's step input to pin 3 and direction input to pin 4.
+ */
+#include <Arduino.h>
+#include <Derivs_Limiter_Stepper.h>
+
+const int STEP_PIN = 3;
+const int DIR_PIN = 4;
+
+Derivs_Limiter limiter = Derivs_Limiter(5, 10); // velocityLimit (revolutions per second), accelerationLimit
+Derivs_Limiter_Stepper<64> stepper(&limiter, 200, 20000); // limiter, steps per revolution, ticks per second (the interrupt's rate)
+
+ISR(TIMER2_COMPA_vect)
+{
+    static Derivs_Limiter_Stepper_Pulse pulse;
+    static bool waiting = false;
+    static unsigned long countdown = 0;
+    if (!waiting) {
+        if (!stepper.take(pulse)) {
+            return;
+        }
+        waiting = true;
+        countdown = pulse.interval;
+    }
+    if (countdown > 0) {
+        countdown--;
+        return;
+    }
+    digitalWrite(DIR_PIN, pulse.forward ? HIGH : LOW);
+    digitalWrite(STEP_PIN, HIGH);
+    delayMicroseconds(2);
+    digitalWrite(STEP_PIN, LOW);
+    waiting = false;
+}
+
+void setup()
+{
+    pinMode(STEP_PIN, OUTPUT);
+    pinMode(DIR_PIN, OUTPUT);
+    noInterrupts();
+    TCCR2A = _BV(WGM21); // CTC mode
+    TCCR2B = _BV(CS21); // 16 MHz / 8
+    OCR2A = 99; // / 100 = 20 kHz
+    TIMSK2 = _BV(OCIE2A);
+    interrupts();
+}
+
+void loop()
+{
+    if (millis() % 10000 < 5000) { // toggles every 5 seconds, the target can change at any time, even during a move
+        limiter.setTarget(0);
+    } else {
+        limiter.setTarget(10);
+    }
+    stepper.refill();
+}
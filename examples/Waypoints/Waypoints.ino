@@ -0,0 +1,40 @@
+/**
+ * Waypoints, an example for the Derivs_Limiter library
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * A servo follows a path of waypoints with Derivs_Limiter_Waypoints.
+ * It doesn't stop at 45 or 90 on the way up to 180, it only stops where it turns around (180 and 20) and slows down as needed for those stops.
+ * The serial plotter shows position and velocity.
+ *
+ * Connect a servo to power and pin 9.
+ */
+#include <Arduino.h>
+#include <Derivs_Limiter_Waypoints.h>
+#include <Servo.h>
+
+const float path[] = { 45, 90, 180, 120, 60, 20 };
+const int PATH_LENGTH = sizeof(path) / sizeof(path[0]);
+
+Derivs_Limiter limiter = Derivs_Limiter(100, 100, 200, 20, 20); // velocityLimit, accelerationLimit, decelerationLimit, target, startPos
+Derivs_Limiter_Waypoints<PATH_LENGTH> waypoints(&limiter);
+Servo myServo;
+
+void setup()
+{
+    Serial.begin(115200);
+    myServo.attach(9);
+}
+
+void loop()
+{
+    if (waypoints.size() == 0 && limiter.isIdle()) { // finished the path, start it again
+        for (int i = 0; i < PATH_LENGTH; i++) {
+            waypoints.add(path[i]);
+        }
+    }
+    myServo.write(waypoints.calc());
+    Serial.print(limiter.getPosition());
+    Serial.print(",");
+    Serial.println(limiter.getVelocity());
+    delay(10);
+}
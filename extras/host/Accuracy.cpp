@@ -0,0 +1,233 @@
+/**
+ * Accuracy, compares Derivs_Limiter with the ideal continuous trapezoidal profile at different update rates
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Every combination of time interval (dt), jitter, limits, and maxStoppingDecel runs the same moves (from rest at 0 to each of several targets)
+ * and is compared with Derivs_Limiter_Profile, which solves the same move in closed form.
+ * Jitter: none, uniform (each dt is 0.5 to 1.5 times dt), spikes (every 20th dt is 5 times longer).
+ * Variants: float (Derivs_Limiter), double (Derivs_Limiter_T<double>), compact (Derivs_Limiter_Compact), bank (Derivs_Limiter_Bank),
+ * each given the same intervals, so max_diff_vs_float shows whether another variant follows Derivs_Limiter exactly,
+ * and substep (Derivs_Limiter with Derivs_Limiter_Sub_Step_Features and setMaxSubStep(0.002)), which is expected to differ from float once dt is longer than 2 ms.
+ * Use it to find the slowest loop that's still accurate enough, or to check a new variant against Derivs_Limiter.
+ * Prints csv, one row for each combination, with the worst value over its moves:
+ * max_pos_error: largest distance from the ideal position at the same time
+ * max_overshoot: largest distance past the target
+ * max_settle_excess: seconds until position stops at the target minus the ideal duration (inf if it never does)
+ * max_final_error: distance from the target after 1.5 times the ideal duration plus 1 second
+ * max_vel_excess: largest speed above velLimit
+ * max_decel_ratio: largest slowing down, divided by decelLimit (maxStoppingDecel lets this go above 1 near the target)
+ * max_diff_vs_float: largest difference in position from the float variant
+ * Returns 1 if compact or bank is ever different from float, since they're documented to give the same position and velocity as Derivs_Limiter.
+ */
+#include <Derivs_Limiter_Bank.h>
+#include <Derivs_Limiter_Compact.h>
+#include <Derivs_Limiter_Profile.h>
+#include <stdio.h>
+#include <vector>
+
+struct Limits {
+    float velLimit;
+    float accelLimit;
+    float decelLimit;
+    float maxStoppingDecel;
+};
+
+struct Metrics {
+    double maxPosError;
+    double maxOvershoot;
+    double maxSettleExcess;
+    double maxFinalError;
+    double maxVelExcess;
+    double maxDecelRatio;
+    double maxDiffVsFloat;
+};
+
+// one class per variant, all used the same way by simulate()
+
+struct FloatAxis {
+    Derivs_Limiter l;
+    void reset(const Limits& c, float target)
+    {
+        l = Derivs_Limiter(c.velLimit, c.accelLimit, c.decelLimit, target, 0, 0, false, false, -INFINITY, INFINITY, c.maxStoppingDecel);
+    }
+    void step(double dt) { l.step(dt); }
+    double position() { return l.getPosition(); }
+    double velocity() { return l.getVelocity(); }
+};
+
+struct DoubleAxis {
+    Derivs_Limiter_T<double> l;
+    void reset(const Limits& c, float target)
+    {
+        l = Derivs_Limiter_T<double>(c.velLimit, c.accelLimit, c.decelLimit, target, 0, 0, false, false, -INFINITY, INFINITY, c.maxStoppingDecel);
+    }
+    void step(double dt) { l.step(dt); }
+    double position() { return l.getPosition(); }
+    double velocity() { return l.getVelocity(); }
+};
+
+struct SubStepAxis {
+    typedef Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Sub_Step_Features> Limiter;
+    Limiter l;
+    void reset(const Limits& c, float target)
+    {
+        l = Limiter(c.velLimit, c.accelLimit, c.decelLimit, target, 0, 0, false, false, -INFINITY, INFINITY, c.maxStoppingDecel);
+        l.setMaxSubStep(0.002);
+    }
+    void step(double dt) { l.step(dt); }
+    double position() { return l.getPosition(); }
+    double velocity() { return l.getVelocity(); }
+};
+
+struct CompactAxis {
+    Derivs_Limiter_Shared_Limits limits;
+    Derivs_Limiter_Compact l;
+    void reset(const Limits& c, float target)
+    {
+        limits = Derivs_Limiter_Shared_Limits(c.velLimit, c.accelLimit, c.decelLimit, false, false, -INFINITY, INFINITY, c.maxStoppingDecel);
+        l = Derivs_Limiter_Compact(&limits);
+        l.setTarget(target);
+    }
+    void step(double dt) { l.step(dt); }
+    double position() { return l.getPosition(); }
+    double velocity() { return l.getVelocity(); }
+};
+
+struct BankAxis {
+    Derivs_Limiter_Bank<1> l;
+    void reset(const Limits& c, float target)
+    {
+        l = Derivs_Limiter_Bank<1>(c.velLimit, c.accelLimit, c.decelLimit);
+        l.setMaxStoppingDecel(0, c.maxStoppingDecel);
+        l.setTarget(0, target);
+    }
+    void step(double dt) { l.step(dt); }
+    double position() { return l.getPosition(0); }
+    double velocity() { return l.getVelocity(0); }
+};
+
+static unsigned long seed = 1;
+static double randomDouble()
+{
+    seed = seed * 1103515245 + 12345;
+    return ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+/**
+ * the time intervals of one move, the same for every variant
+ */
+static void makeIntervals(std::vector<float>& dts, float dt, int jitter, double duration)
+{
+    dts.clear();
+    seed = 12345;
+    double t = 0;
+    for (size_t i = 0; t < duration; i++) {
+        float d = dt;
+        if (jitter == 1) {
+            d = dt * (0.5 + randomDouble());
+        } else if (jitter == 2 && i % 20 == 19) {
+            d = dt * 5;
+        }
+        dts.push_back(d);
+        t += d;
+    }
+}
+
+template <typename Axis>
+static void simulate(Metrics& m, const Limits& c, float target, const std::vector<float>& dts, std::vector<double>& positions, bool isReference)
+{
+    Axis axis;
+    axis.reset(c, target);
+    Derivs_Limiter_Profile_T<double> ideal;
+    ideal.plan(0, 0, target, c.velLimit, c.accelLimit, c.decelLimit);
+    double direction = (target > 0) ? 1 : -1;
+    double t = 0;
+    double settle = INFINITY;
+    double lastVel = 0;
+    for (size_t i = 0; i < dts.size(); i++) {
+        axis.step(dts[i]);
+        t += dts[i];
+        double pos = axis.position();
+        double vel = axis.velocity();
+        double idealPos = target, idealVel = 0, idealAcc = 0; // what evaluate() gives after the end of the move, and left as that if it has no plan
+        ideal.evaluate(t, idealPos, idealVel, idealAcc);
+        m.maxPosError = max(m.maxPosError, abs(pos - idealPos));
+        m.maxOvershoot = max(m.maxOvershoot, (pos - target) * direction);
+        m.maxVelExcess = max(m.maxVelExcess, abs(vel) - c.velLimit);
+        if (abs(vel) < abs(lastVel)) {
+            m.maxDecelRatio = max(m.maxDecelRatio, (abs(lastVel) - abs(vel)) / dts[i] / c.decelLimit);
+        }
+        lastVel = vel;
+        if (settle == INFINITY && pos == target && vel == 0) {
+            settle = t;
+        }
+        if (isReference) {
+            positions[i] = pos;
+        } else {
+            m.maxDiffVsFloat = max(m.maxDiffVsFloat, abs(pos - positions[i]));
+        }
+    }
+    m.maxSettleExcess = max(m.maxSettleExcess, settle - ideal.getDuration());
+    m.maxFinalError = max(m.maxFinalError, abs(axis.position() - target));
+}
+
+int main()
+{
+    const float dts[] = { 0.0001, 0.001, 0.005, 0.01, 0.02, 0.05 };
+    const char* jitterNames[] = { "none", "uniform", "spikes" };
+    const Limits limitSets[] = {
+        { 100, 100, 100, 0 },
+        { 100, 400, 50, 0 },
+        { 20, 1000, 1000, 0 },
+        { 300, 50, 200, 0 },
+    };
+    const float maxStoppingDecels[] = { 1, 2, 4 };
+    const float targets[] = { 1, -10, 100 };
+    const char* variantNames[] = { "float", "double", "compact", "bank", "substep" };
+    const size_t variants = sizeof(variantNames) / sizeof(variantNames[0]);
+    const size_t sameAsFloat[] = { 2, 3 }; // compact and bank
+    int errors = 0;
+
+    printf("variant,dt_ms,jitter,vel_limit,accel_limit,decel_limit,max_stopping_decel,moves,"
+           "max_pos_error,max_overshoot,max_settle_excess,max_final_error,max_vel_excess,max_decel_ratio,max_diff_vs_float\n");
+    std::vector<float> intervals;
+    for (size_t d = 0; d < sizeof(dts) / sizeof(dts[0]); d++) {
+        for (int jitter = 0; jitter < 3; jitter++) {
+            for (size_t l = 0; l < sizeof(limitSets) / sizeof(limitSets[0]); l++) {
+                for (size_t s = 0; s < sizeof(maxStoppingDecels) / sizeof(maxStoppingDecels[0]); s++) {
+                    Limits c = limitSets[l];
+                    c.maxStoppingDecel = maxStoppingDecels[s];
+                    Metrics metrics[variants] = {};
+                    for (size_t v = 0; v < variants; v++) {
+                        metrics[v].maxSettleExcess = -INFINITY; // can be negative
+                    }
+                    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+                        Derivs_Limiter_Profile_T<double> ideal;
+                        ideal.plan(0, 0, targets[t], c.velLimit, c.accelLimit, c.decelLimit);
+                        makeIntervals(intervals, dts[d], jitter, ideal.getDuration() * 1.5 + 1);
+                        std::vector<double> reference(intervals.size());
+                        simulate<FloatAxis>(metrics[0], c, targets[t], intervals, reference, true);
+                        simulate<DoubleAxis>(metrics[1], c, targets[t], intervals, reference, false);
+                        simulate<CompactAxis>(metrics[2], c, targets[t], intervals, reference, false);
+                        simulate<BankAxis>(metrics[3], c, targets[t], intervals, reference, false);
+                        simulate<SubStepAxis>(metrics[4], c, targets[t], intervals, reference, false);
+                    }
+                    for (size_t v = 0; v < variants; v++) {
+                        const Metrics& m = metrics[v];
+                        printf("%s,%g,%s,%g,%g,%g,%g,%zu,%g,%g,%g,%g,%g,%g,%g\n", variantNames[v], dts[d] * 1000.0, jitterNames[jitter],
+                            c.velLimit, c.accelLimit, c.decelLimit, c.maxStoppingDecel, sizeof(targets) / sizeof(targets[0]),
+                            m.maxPosError, m.maxOvershoot, m.maxSettleExcess, m.maxFinalError, m.maxVelExcess, m.maxDecelRatio, m.maxDiffVsFloat);
+                    }
+                    for (size_t v = 0; v < sizeof(sameAsFloat) / sizeof(sameAsFloat[0]); v++) {
+                        if (metrics[sameAsFloat[v]].maxDiffVsFloat != 0) {
+                            fprintf(stderr, "%s differs from float by %g at dt %g ms, jitter %s, limits %g %g %g, maxStoppingDecel %g\n", variantNames[sameAsFloat[v]],
+                                metrics[sameAsFloat[v]].maxDiffVsFloat, dts[d] * 1000.0, jitterNames[jitter], c.velLimit, c.accelLimit, c.decelLimit, c.maxStoppingDecel);
+                            errors++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * BankMatch, checks that each channel of a Derivs_Limiter_Bank gives the same results as a Derivs_Limiter
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * 64 Derivs_Limiters get random limits (some with position limits, preventGoingWrongWay or preventGoingTooFast turned off, some with maxStoppingDecel changed)
+ * and are copied into a bank with copyFrom(). Both are then stepped with the same random time intervals (0.0001 to 0.02 s), and every so often
+ * each limiter gets the same random change as its channel: a new target, a velocity target, a new position, a new velocity or new limits.
+ * After every step position, velocity and acceleration of each channel must be bit-identical to its Derivs_Limiter.
+ * Where SIMD instructions are available (see Derivs_Limiter_SIMD.h) this checks the SIMD path; BankMatchNoSIMD checks the scalar one.
+ * On x86-64 BankMatch is built for SSE2, and BankMatchAVX2 (built with -mavx2 -mfma, only where the computer building it can run them) checks the AVX2 path.
+ * On AArch64 BankMatch checks the NEON path.
+ * Usage: BankMatch [steps]
+ * Prints a summary and returns 1 if anything was different.
+ */
+#include <Derivs_Limiter_Bank.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t count = 64;
+
+static unsigned long seed = 1;
+static float randomFloat(float low, float high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0f;
+}
+
+static bool same(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static Derivs_Limiter limiters[count];
+static Derivs_Limiter_Bank<count> bank;
+
+/**
+ * gives limiter i and channel i the same random change
+ */
+static void change(size_t i)
+{
+    Derivs_Limiter& l = limiters[i];
+    float choice = randomFloat(0, 1);
+    if (choice < 0.5) {
+        float target = randomFloat(-200, 200);
+        l.setTarget(target);
+        bank.setTarget(i, target);
+    } else if (choice < 0.65) {
+        float vel = randomFloat(-300, 300);
+        l.setVelTarget(vel);
+        bank.setVelTarget(i, vel);
+    } else if (choice < 0.75) {
+        float pos = randomFloat(-200, 200);
+        l.setPosition(pos);
+        bank.setPosition(i, pos);
+    } else if (choice < 0.85) {
+        float vel = randomFloat(-300, 300);
+        l.setVelocity(vel);
+        bank.setVelocity(i, vel);
+    } else {
+        float velLimit = randomFloat(1, 300), accelLimit = randomFloat(1, 1000), decelLimit = randomFloat(1, 1000);
+        l.setVelAccelLimits(velLimit, accelLimit, decelLimit);
+        bank.setVelAccelLimits(i, velLimit, accelLimit, decelLimit);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    long steps = 20000;
+    if (argc > 1) {
+        steps = atol(argv[1]);
+    }
+    for (size_t i = 0; i < count; i++) {
+        Derivs_Limiter& l = limiters[i];
+        l = Derivs_Limiter(randomFloat(1, 300), randomFloat(1, 1000), randomFloat(1, 1000), randomFloat(-200, 200));
+        if (i % 4 == 1) {
+            l.setPosLimits(randomFloat(-150, 0), randomFloat(0, 150));
+        }
+        if (i % 5 == 2) {
+            l.setPreventGoingWrongWay(false);
+        }
+        if (i % 6 == 3) {
+            l.setPreventGoingTooFast(false);
+        }
+        if (i % 7 == 4) {
+            l.setMaxStoppingDecel(randomFloat(1, 4));
+        }
+        bank.copyFrom(i, l);
+    }
+
+    long differences = 0;
+    for (long s = 0; s < steps; s++) {
+        if (s % 50 == 0) {
+            for (size_t i = 0; i < count; i++) {
+                if (randomFloat(0, 1) < 0.3) {
+                    change(i);
+                }
+            }
+        }
+        float dt = randomFloat(0.0001, 0.02);
+        for (size_t i = 0; i < count; i++) {
+            limiters[i].step(dt);
+        }
+        bank.step(dt);
+        for (size_t i = 0; i < count; i++) {
+            if (!same(limiters[i].getPosition(), bank.getPosition(i)) || !same(limiters[i].getVelocity(), bank.getVelocity(i))
+                || !same(limiters[i].getAcceleration(), bank.getAcceleration(i))) {
+                differences++;
+                if (differences <= 3) {
+                    printf("  step %ld channel %zu: limiter %.9g %.9g %.9g, bank %.9g %.9g %.9g\n", s, i, limiters[i].getPosition(), limiters[i].getVelocity(),
+                        limiters[i].getAcceleration(), bank.getPosition(i), bank.getVelocity(i), bank.getAcceleration(i));
+                }
+                bank.copyFrom(i, limiters[i]); // so one difference is only counted once
+            }
+        }
+    }
+#ifdef DERIVS_LIMITER_SIMD
+    size_t lanes = Derivs_Limiter_SIMD::width;
+#else
+    size_t lanes = 1;
+#endif
+    printf("%zu channels, %ld steps, %zu lanes at a time: differences %ld\n", count, steps, lanes, differences);
+    return differences ? 1 : 0;
+}
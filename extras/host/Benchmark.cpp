@@ -0,0 +1,266 @@
+/**
+ * Benchmark, measures how long one calculation takes in each part (regime) of the calculation
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Every channel is started in a state that stays in one regime for the whole measurement
+ * (see Derivs_Limiter_Kernel::Regime), then stepped with a fixed dt:
+ * at_target, accelerate, coast, decel_to_target, wrong_way_decel, too_fast_decel, velocity_mode,
+ * and random, where every channel gets a random target and limits every 100 steps.
+ * Variants: limiter (Derivs_Limiter::step()), compact (Derivs_Limiter_Compact), bank (Derivs_Limiter_Bank::step(),
+ * bank_simd when SIMD is used, BenchmarkNoSIMD is built without it), and fixed_rate (Derivs_Limiter_Fixed_Rate::tick()).
+ * regime_fraction is the share of steps in which one channel actually was in the regime, checked with Derivs_Limiter_Kernel.
+ * instructions_per_step comes from the CPU's counter on Linux, and is nan where that can't be read (no permission, virtual machine).
+ * Usage: Benchmark [milliseconds per measurement]
+ * Prints csv: variant,regime,channels,steps,ns_per_step,instructions_per_step,regime_fraction
+ */
+#include <Derivs_Limiter_Bank.h>
+#include <Derivs_Limiter_Compact.h>
+#include <Derivs_Limiter_Fixed_Rate.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const size_t channels = 256;
+static const size_t stepsPerRun = 1000; // short enough that every scenario stays in its regime
+static const float dt = 0.001;
+
+struct Scenario {
+    const char* name;
+    Derivs_Limiter_Kernel::Regime regime;
+    bool velocityMode;
+    float position;
+    float velocity;
+    float target; // velocity target in velocity mode
+    float velLimit;
+    float accelLimit;
+    float decelLimit;
+};
+
+static const Scenario scenarios[] = {
+    { "at_target", Derivs_Limiter_Kernel::AT_TARGET, false, 0, 0, 0, 10, 10, 10 },
+    { "accelerate", Derivs_Limiter_Kernel::ACCELERATE, false, 0, 0, 1e9, 1e9, 0.001, 1e9 },
+    { "coast", Derivs_Limiter_Kernel::COAST, false, 0, 10, 1e9, 10, 10, 10 },
+    { "decel_to_target", Derivs_Limiter_Kernel::DECEL_TO_TARGET, false, 0, 1000, 500000, 1000, 1, 1 },
+    { "wrong_way_decel", Derivs_Limiter_Kernel::WRONG_WAY_DECEL, false, 0, -1000, 1e6, 1000, 1, 1 },
+    { "too_fast_decel", Derivs_Limiter_Kernel::TOO_FAST_DECEL, false, 0, 10000, 1e9, 1, 1, 1 },
+    { "velocity_mode", Derivs_Limiter_Kernel::VELOCITY_MODE, true, 0, 0, 1e6, 1e9, 1, 1 },
+    { "random", Derivs_Limiter_Kernel::AT_TARGET, false, 0, 0, 0, 0, 0, 0 } // regime not checked
+};
+static const size_t scenarioCount = sizeof(scenarios) / sizeof(scenarios[0]);
+static const size_t randomScenario = scenarioCount - 1;
+
+static Derivs_Limiter limiters[channels];
+static Derivs_Limiter_Compact compacts[channels];
+static Derivs_Limiter_Shared_Limits sharedLimits[channels]; // one each, so compacts get the same settings as the others
+static Derivs_Limiter_Bank<channels> bank;
+static Derivs_Limiter_Fixed_Rate fixedRates[channels];
+static volatile float sink;
+
+static unsigned long seed = 1;
+static float randomFloat(float low, float high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0f;
+}
+
+/**
+ * the same random settings for every variant, so they do the same work
+ */
+static void randomize(size_t run, size_t i, float& target, float& velLimit, float& accelLimit)
+{
+    seed = (run * channels + i) * 2654435761u + 1;
+    target = randomFloat(-100, 100);
+    velLimit = randomFloat(5, 50);
+    accelLimit = randomFloat(5, 50);
+}
+
+static void setUp(const Scenario& s)
+{
+    for (size_t i = 0; i < channels; i++) {
+        limiters[i] = Derivs_Limiter(s.velLimit, s.accelLimit, s.decelLimit);
+        limiters[i].setPositionVelocity(s.position, s.velocity);
+        sharedLimits[i] = Derivs_Limiter_Shared_Limits(s.velLimit, s.accelLimit, s.decelLimit);
+        compacts[i] = Derivs_Limiter_Compact(&sharedLimits[i], s.position);
+        compacts[i].setVelocity(s.velocity);
+        bank.setVelAccelLimits(i, s.velLimit, s.accelLimit, s.decelLimit);
+        bank.setPosition(i, s.position);
+        bank.setVelocity(i, s.velocity);
+        fixedRates[i] = Derivs_Limiter_Fixed_Rate(dt, s.velLimit, s.accelLimit, s.decelLimit, s.position);
+        fixedRates[i].setVelocity(s.velocity);
+        if (s.velocityMode) {
+            limiters[i].setVelTarget(s.target);
+            compacts[i].setVelTarget(s.target);
+            bank.setVelTarget(i, s.target);
+            fixedRates[i].setVelTarget(s.target);
+        } else {
+            limiters[i].setTarget(s.target);
+            compacts[i].setTarget(s.target);
+            bank.setTarget(i, s.target);
+            fixedRates[i].setTarget(s.target);
+        }
+    }
+}
+
+static void retarget(size_t variant, size_t run)
+{
+    for (size_t i = 0; i < channels; i++) {
+        float target, velLimit, accelLimit;
+        randomize(run, i, target, velLimit, accelLimit);
+        if (variant == 0) {
+            limiters[i].setVelAccelLimits(velLimit, accelLimit, accelLimit);
+            limiters[i].setTarget(target);
+        } else if (variant == 1) {
+            sharedLimits[i] = Derivs_Limiter_Shared_Limits(velLimit, accelLimit);
+            compacts[i].setTarget(target);
+        } else if (variant == 2) {
+            bank.setVelAccelLimits(i, velLimit, accelLimit, accelLimit);
+            bank.setTarget(i, target);
+        } else {
+            fixedRates[i].setVelAccelLimits(velLimit, accelLimit, accelLimit);
+            fixedRates[i].setTarget(target);
+        }
+    }
+}
+
+/**
+ * stepsPerRun steps of every channel of one variant
+ */
+static void run(size_t variant, bool random, size_t runNumber)
+{
+    for (size_t t = 0; t < stepsPerRun; t++) {
+        if (random && t % 100 == 0) {
+            retarget(variant, runNumber * stepsPerRun + t);
+        }
+        if (variant == 0) {
+            for (size_t i = 0; i < channels; i++) {
+                limiters[i].step(dt);
+            }
+        } else if (variant == 1) {
+            for (size_t i = 0; i < channels; i++) {
+                compacts[i].step(dt);
+            }
+        } else if (variant == 2) {
+            bank.step(dt);
+        } else {
+            for (size_t i = 0; i < channels; i++) {
+                fixedRates[i].tick();
+            }
+        }
+    }
+    sink = limiters[0].getPosition() + compacts[0].getPosition() + bank.getPosition(0) + fixedRates[0].getPosition();
+}
+
+/**
+ * share of stepsPerRun steps where one channel is in the expected regime
+ */
+static float regimeFraction(const Scenario& s)
+{
+    float position = s.position;
+    float velocity = s.velocity;
+    float accel = 0;
+    float target = s.target;
+    size_t matches = 0;
+    for (size_t t = 0; t < stepsPerRun; t++) {
+        Derivs_Limiter_Kernel::Regime r;
+        if (s.velocityMode) {
+            r = Derivs_Limiter_Kernel::velMode(position, velocity, accel, target, s.velLimit, s.accelLimit, s.decelLimit, false, dt);
+        } else {
+            r = Derivs_Limiter_Kernel::posMode(position, velocity, accel, target, s.velLimit, s.accelLimit, s.decelLimit, (float)2, false, dt);
+        }
+        matches += (r == s.regime);
+    }
+    return (float)matches / stepsPerRun;
+}
+
+#if defined(__linux__)
+static int instructionCounter = -1;
+static void openInstructionCounter()
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    instructionCounter = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+static void startInstructions()
+{
+    if (instructionCounter >= 0) {
+        ioctl(instructionCounter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(instructionCounter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+static double stopInstructions()
+{
+    long long count = 0;
+    if (instructionCounter < 0) {
+        return NAN;
+    }
+    ioctl(instructionCounter, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(instructionCounter, &count, sizeof(count)) != sizeof(count)) {
+        return NAN;
+    }
+    return (double)count;
+}
+#else
+static void openInstructionCounter() { }
+static void startInstructions() { }
+static double stopInstructions()
+{
+    return NAN;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    double minSeconds = 0.1;
+    if (argc > 1) {
+        minSeconds = atof(argv[1]) / 1000.0;
+    }
+    openInstructionCounter();
+#ifdef DERIVS_LIMITER_SIMD
+    const char* variantNames[4] = { "limiter", "compact", "bank_simd", "fixed_rate" };
+#else
+    const char* variantNames[4] = { "limiter", "compact", "bank", "fixed_rate" };
+#endif
+
+    printf("variant,regime,channels,steps,ns_per_step,instructions_per_step,regime_fraction\n");
+    for (size_t s = 0; s < scenarioCount; s++) {
+        bool random = (s == randomScenario);
+        float fraction = random ? NAN : regimeFraction(scenarios[s]);
+        for (size_t variant = 0; variant < 4; variant++) {
+            double best = INFINITY;
+            double bestInstructions = NAN;
+            double total = 0;
+            size_t runs = 0;
+            while (total < minSeconds || runs < 3) {
+                setUp(scenarios[s]); // every run starts from the same state, so it stays in the regime
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                startInstructions();
+                run(variant, random, runs);
+                double instructions = stopInstructions();
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                total += seconds;
+                if (seconds < best) {
+                    best = seconds;
+                    bestInstructions = instructions;
+                }
+                runs++;
+            }
+            double steps = (double)channels * stepsPerRun;
+            printf("%s,%s,%zu,%.0f,%.3f,%.1f,%.3f\n", variantNames[variant], scenarios[s].name, channels, steps,
+                best * 1e9 / steps, bestInstructions / steps, fraction);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * FixedRateMatch, checks that Derivs_Limiter_Fixed_Rate gives the same results as a Derivs_Limiter stepped with the same time step
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Each run gets a random time step (0.0001 to 0.02 s), random limits, a random start position and velocity, and some have preventGoingWrongWay,
+ * preventGoingTooFast or a different maxStoppingDecel. Every 400 ticks both get the same random change: usually a new target, sometimes a velocity target,
+ * and sometimes new limits (so the kept products have to be worked out again).
+ * After every tick position and velocity must be bit-identical to the Derivs_Limiter's, and acceleration within a rounding error of it
+ * (Derivs_Limiter_Fixed_Rate multiplies by 1 / timestep instead of dividing).
+ * Usage: FixedRateMatch [number of runs]
+ * Prints a summary and returns 1 if anything was different.
+ */
+#include <Derivs_Limiter_Fixed_Rate.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int ticksPerRun = 3000;
+
+static unsigned long seed = 1;
+static float randomFloat(float low, float high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0f;
+}
+
+static bool same(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    long runs = 3000;
+    if (argc > 1) {
+        runs = atol(argv[1]);
+    }
+    long ticks = 0, different = 0, accelDifferent = 0;
+    for (long run = 0; run < runs; run++) {
+        float dt = randomFloat(0.0001, 0.02);
+        float velLimit = randomFloat(0.1, 500);
+        float accelLimit = randomFloat(0.1, 5000);
+        float decelLimit = randomFloat(0.1, 5000);
+        float start = randomFloat(-100, 100);
+        Derivs_Limiter l = Derivs_Limiter(velLimit, accelLimit, decelLimit, start, start, randomFloat(-300, 300)); // Derivs_Limiter_Fixed_Rate starts with target at the start position
+        Derivs_Limiter_Fixed_Rate f = Derivs_Limiter_Fixed_Rate(dt, velLimit, accelLimit, decelLimit, start);
+        f.setVelocity(l.getVelocity());
+        bool wrongWay = (run % 3 == 1), tooFast = (run % 5 == 2);
+        l.setPreventGoingWrongWay(wrongWay);
+        f.setPreventGoingWrongWay(wrongWay);
+        l.setPreventGoingTooFast(tooFast);
+        f.setPreventGoingTooFast(tooFast);
+        if (run % 7 == 3) {
+            l.setMaxStoppingDecel(randomFloat(1, 4));
+            f.setMaxStoppingDecel(l.getMaxStoppingDecel());
+        }
+        bool reported = false;
+        for (int i = 0; i < ticksPerRun; i++) {
+            if (i % 400 == 0) {
+                float r = randomFloat(0, 1);
+                if (r < 0.7) {
+                    float target = randomFloat(-200, 200);
+                    l.setTarget(target);
+                    f.setTarget(target);
+                } else if (r < 0.85) {
+                    float velTarget = randomFloat(-600, 600);
+                    l.setVelTarget(velTarget);
+                    f.setVelTarget(velTarget);
+                } else {
+                    l.setVelAccelLimits(randomFloat(0.1, 500), randomFloat(0.1, 5000), randomFloat(0.1, 5000));
+                    f.setVelAccelLimits(l.getVelLimit(), l.getAccelLimit(), l.getDecelLimit());
+                }
+            }
+            l.step(dt);
+            f.tick();
+            ticks++;
+            if (!same(l.getPosition(), f.getPosition()) || !same(l.getVelocity(), f.getVelocity())) {
+                different++;
+                if (!reported) {
+                    reported = true;
+                    printf("  run %ld tick %d dt=%g: position %.9g and %.9g, velocity %.9g and %.9g\n",
+                        run, i, dt, l.getPosition(), f.getPosition(), l.getVelocity(), f.getVelocity());
+                }
+                f.setPosition(l.getPosition()); // keep checking the rest of the run from the same state
+                f.setVelocity(l.getVelocity());
+            }
+            if (abs(l.getAcceleration() - f.getAcceleration()) > 1e-3 * abs(l.getAcceleration()) + 1e-3) {
+                accelDifferent++;
+            }
+        }
+    }
+    printf("%ld runs, %ld ticks: position or velocity different %ld, acceleration different %ld\n", runs, ticks, different, accelDifferent);
+    printf("errors: %ld\n", different + accelDifferent);
+    return (different + accelDifferent) ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * GenerateMatch, checks that generate() gives the same results as calling step() the same number of times
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Each run makes two limiters with the same random limits (velLimit 0.1 to 300, accelLimit and decelLimit 0.1 to 1000), start position and velocity,
+ * and a random time interval (0.1 to 20 ms), then 20 times gives both the same random change (a new target, a velocity target, or new limits) and
+ * moves them on by a chunk of 1 to 200 samples: one with generate(), the other with step() in a loop. Chunks use stride 1 with separate arrays, stride 2
+ * with one interleaved array, or NULL for one or both arrays. Runs on Derivs_Limiter, Derivs_Limiter_T<double>, Basic features, the Jerk feature
+ * (setJerkLimit()), the SubSteps feature (setMaxSubStep() shorter than the interval) and with position and velocity pointers. Checks that
+ * - every position and velocity written is bit-identical to the stepped limiter's after the same step
+ * - nothing outside the samples is written
+ * - after each chunk position, velocity, acceleration and target are bit-identical, so the next chunk continues from the same state
+ * Usage: GenerateMatch [number of runs for each limiter type]
+ * Prints a summary for each limiter type and returns 1 if anything was different.
+ */
+#include <Derivs_Limiter.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int chunksPerRun = 20;
+static const size_t maxChunk = 200;
+
+static unsigned long seed = 1;
+static double randomDouble(double low, double high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+template <typename Scalar>
+static bool same(Scalar a, Scalar b)
+{
+    return memcmp(&a, &b, sizeof(Scalar)) == 0;
+}
+
+struct Result {
+    long samples;
+    long different; // samples with a different position or velocity
+    long overwritten; // chunks that wrote outside their samples
+    long stateDifferent; // chunks that ended in a different state
+};
+
+/**
+ * nothing to set up beyond the limits
+ */
+template <typename Limiter>
+static void noSetup(Limiter& a, Limiter& b, typename Limiter::ScalarType dt)
+{
+    (void)a;
+    (void)b;
+    (void)dt;
+}
+
+template <typename Limiter>
+static void jerkSetup(Limiter& a, Limiter& b, typename Limiter::ScalarType dt)
+{
+    (void)dt;
+    typename Limiter::ScalarType jerkLimit = randomDouble(10, 20000);
+    a.setJerkLimit(jerkLimit);
+    b.setJerkLimit(jerkLimit);
+}
+
+template <typename Limiter>
+static void subStepSetup(Limiter& a, Limiter& b, typename Limiter::ScalarType dt)
+{
+    typename Limiter::ScalarType maxSubStep = dt * randomDouble(0.1, 1.2);
+    a.setMaxSubStep(maxSubStep);
+    b.setMaxSubStep(maxSubStep);
+}
+
+static float positionA, velocityA, positionB, velocityB;
+static void pointerSetup(Derivs_Limiter& a, Derivs_Limiter& b, float dt)
+{
+    (void)dt;
+    positionA = positionB = a.getPosition();
+    velocityA = velocityB = a.getVelocity();
+    a.setPositionPointer(&positionA);
+    a.setVelocityPointer(&velocityA);
+    b.setPositionPointer(&positionB);
+    b.setVelocityPointer(&velocityB);
+}
+
+/**
+ * one run, returns true if generate() matched step() all the way through
+ */
+template <typename Limiter>
+static bool runOne(Result& r, void (*setup)(Limiter&, Limiter&, typename Limiter::ScalarType))
+{
+    typedef typename Limiter::ScalarType Scalar;
+    Scalar dt = randomDouble(0.0001, 0.02);
+    Scalar velLimit = randomDouble(0.1, 300);
+    Scalar accelLimit = randomDouble(0.1, 1000);
+    Scalar decelLimit = randomDouble(0.1, 1000);
+    Scalar start = randomDouble(-100, 100);
+    Scalar startVelocity = randomDouble(-300, 300);
+    Limiter a = Limiter(velLimit, accelLimit, decelLimit, start, start, startVelocity);
+    Limiter b = Limiter(velLimit, accelLimit, decelLimit, start, start, startVelocity);
+    setup(a, b, dt);
+
+    const Scalar unwritten = -12345;
+    Scalar pos[maxChunk + 1], vel[maxChunk + 1], interleaved[2 * maxChunk + 1];
+    bool ok = true;
+    for (int chunk = 0; chunk < chunksPerRun; chunk++) {
+        double change = randomDouble(0, 1);
+        if (change < 0.6) {
+            Scalar target = randomDouble(-200, 200);
+            a.setTarget(target);
+            b.setTarget(target);
+        } else if (change < 0.8) {
+            Scalar velTarget = randomDouble(-400, 400);
+            a.setVelTarget(velTarget);
+            b.setVelTarget(velTarget);
+        } else {
+            a.setVelAccelLimits(randomDouble(0.1, 300), randomDouble(0.1, 1000), randomDouble(0.1, 1000));
+            b.setVelAccelLimits(a.getVelLimit(), a.getAccelLimit(), a.getDecelLimit());
+        }
+
+        size_t n = 1 + (size_t)randomDouble(0, maxChunk - 1 + 0.999);
+        for (size_t i = 0; i <= maxChunk; i++) {
+            pos[i] = vel[i] = unwritten;
+        }
+        for (size_t i = 0; i <= 2 * maxChunk; i++) {
+            interleaved[i] = unwritten;
+        }
+        int layout = (int)randomDouble(0, 4.999);
+        Scalar* posOut = pos;
+        Scalar* velOut = vel;
+        size_t stride = 1;
+        switch (layout) {
+        case 0: // separate arrays
+            break;
+        case 1: // interleaved
+            posOut = interleaved;
+            velOut = interleaved + 1;
+            stride = 2;
+            break;
+        case 2:
+            velOut = NULL;
+            break;
+        case 3:
+            posOut = NULL;
+            break;
+        default:
+            posOut = velOut = NULL;
+            break;
+        }
+        a.generate(posOut, velOut, n, dt, stride);
+
+        bool different = false;
+        for (size_t i = 0; i < n; i++) {
+            b.step(dt);
+            r.samples++;
+            if ((posOut && !same(posOut[i * stride], b.getPosition())) || (velOut && !same(velOut[i * stride], b.getVelocity()))) {
+                r.different++;
+                if (!different && ok) {
+                    printf("  dt=%g chunk %d sample %lu of %lu, stride %lu: position %.9g and %.9g, velocity %.9g and %.9g\n", (double)dt, chunk,
+                        (unsigned long)i, (unsigned long)n, (unsigned long)stride, posOut ? (double)posOut[i * stride] : NAN, (double)b.getPosition(),
+                        velOut ? (double)velOut[i * stride] : NAN, (double)b.getVelocity());
+                }
+                different = true;
+            }
+        }
+        bool overwritten = false;
+        for (size_t i = (posOut == pos) ? n : 0; i <= maxChunk; i++) {
+            overwritten |= !same(pos[i], unwritten);
+        }
+        for (size_t i = (velOut == vel) ? n : 0; i <= maxChunk; i++) {
+            overwritten |= !same(vel[i], unwritten);
+        }
+        for (size_t i = (stride == 2) ? 2 * n : 0; i <= 2 * maxChunk; i++) {
+            overwritten |= !same(interleaved[i], unwritten);
+        }
+        if (overwritten) {
+            r.overwritten++;
+        }
+        if (!same(a.getPosition(), b.getPosition()) || !same(a.getVelocity(), b.getVelocity()) || !same(a.getAcceleration(), b.getAcceleration())
+            || !same(a.getTarget(), b.getTarget())) {
+            r.stateDifferent++;
+            different = true;
+            a = b; // keep checking the rest of the run from the same state
+        }
+        if (different || overwritten) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+template <typename Limiter>
+static long runType(const char* name, long runs, void (*setup)(Limiter&, Limiter&, typename Limiter::ScalarType))
+{
+    Result r = Result();
+    long errors = 0;
+    for (long i = 0; i < runs; i++) {
+        if (!runOne<Limiter>(r, setup)) {
+            errors++;
+        }
+    }
+    printf("%s, %ld runs, %ld samples: different %ld, written outside the samples %ld, different state after a chunk %ld\n",
+        name, runs, r.samples, r.different, r.overwritten, r.stateDifferent);
+    return errors;
+}
+
+int main(int argc, char** argv)
+{
+    long runs = 500;
+    if (argc > 1) {
+        runs = atol(argv[1]);
+    }
+    long errors = 0;
+    errors += runType<Derivs_Limiter>("Derivs_Limiter", runs, noSetup<Derivs_Limiter>);
+    errors += runType<Derivs_Limiter_T<double> >("Derivs_Limiter_T<double>", runs, noSetup<Derivs_Limiter_T<double> >);
+    typedef Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Basic_Features> Basic;
+    errors += runType<Basic>("Basic features", runs, noSetup<Basic>);
+    typedef Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Jerk_Features> Jerk;
+    errors += runType<Jerk>("Jerk feature", runs, jerkSetup<Jerk>);
+    typedef Derivs_Limiter_T<double, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Sub_Step_Features> SubSteps;
+    errors += runType<SubSteps>("SubSteps feature with double", runs, subStepSetup<SubSteps>);
+    errors += runType<Derivs_Limiter>("pointers", runs, pointerSetup);
+    printf("errors: %ld\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * GroupSync, checks that the axes of a Derivs_Limiter_Group arrive at their targets together
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Each move gives three axes, each with its own random limits (velLimit 10 to 300, accelLimit and decelLimit 1 to 1000, so accelLimit != decelLimit)
+ * a random target (10 to 200 either way) through setTargets(), then steps the group at 1 kHz until every axis is stopped at its target.
+ * Checks that the axes stop within 30 time intervals of each other and of the time setTargets() returned: the time is exact for the ideal trapezoid,
+ * and the last approach to the target (decelerating by v^2 / 2 / distance each step) stops between about 7 and 26 steps after the ideal trapezoid would, at any time interval.
+ * The first move has axis A (100, 100, 100) moving 100 and axis B (50, 10, 400) moving 30, where B needs longest and doesn't reach its velLimit.
+ * It's run again with limiters that have only the basic features, to check the group works with other limiter types.
+ * Usage: GroupSync [number of moves]
+ * Prints a summary and returns 1 if anything was wrong.
+ */
+#include <Derivs_Limiter.h>
+#include <Derivs_Limiter_Group.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned long seed = 1;
+static double randomDouble(double low, double high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+const int AXES = 3;
+const double dt = 0.001;
+const double tolerance = 30 * dt;
+
+struct Timing {
+    double duration; // returned by setTargets()
+    double spread; // latest axis to stop - first axis to stop
+    double offBy; // largest difference between when an axis stopped and duration
+};
+
+/**
+ * one group move from 0, INFINITY in spread and offBy if an axis didn't stop
+ */
+template <typename Limiter>
+static Timing runMove(Limiter* const* axes, const double* targets)
+{
+    Timing timing;
+    Derivs_Limiter_Group<AXES, Limiter> group = Derivs_Limiter_Group<AXES, Limiter>(axes);
+    timing.duration = group.setTargets(targets);
+    double stopped[AXES];
+    for (int i = 0; i < AXES; i++) {
+        stopped[i] = INFINITY;
+    }
+    for (long n = 1; n * dt < 2 * timing.duration + 1; n++) {
+        group.step(dt);
+        for (int i = 0; i < AXES; i++) {
+            if (stopped[i] == INFINITY && axes[i]->isPosAtTarget() && axes[i]->getVelocity() == 0) {
+                stopped[i] = n * dt;
+            }
+        }
+        if (group.isIdle()) {
+            break;
+        }
+    }
+    double first = INFINITY, last = 0;
+    timing.offBy = 0;
+    for (int i = 0; i < AXES; i++) {
+        if (targets[i] != 0) { // moved
+            first = min(first, stopped[i]);
+            last = max(last, stopped[i]);
+            timing.offBy = max(timing.offBy, abs(stopped[i] - timing.duration));
+        }
+    }
+    timing.spread = last - first;
+    return timing;
+}
+
+int main(int argc, char** argv)
+{
+    long moves = 2000;
+    if (argc > 1) {
+        moves = atol(argv[1]);
+    }
+    int errors = 0;
+
+    Derivs_Limiter_T<double> a = Derivs_Limiter_T<double>(100, 100, 100);
+    Derivs_Limiter_T<double> b = Derivs_Limiter_T<double>(50, 10, 400);
+    Derivs_Limiter_T<double> c = Derivs_Limiter_T<double>(1, 1, 1);
+    Derivs_Limiter_T<double>* axes[AXES] = { &a, &b, &c };
+    double targets[AXES] = { 100, 30, 0 };
+    Timing timing = runMove(axes, targets);
+    double expected = sqrt(2 * 30 * (1 / 10.0 + 1 / 400.0)); // B doesn't reach velLimit
+    printf("A (100, 100, 100) moving 100 and B (50, 10, 400) moving 30: setTargets() returned %.4f s (expected %.4f s), axes stopped %.4f s apart, at most %.4f s from it\n", timing.duration, expected, timing.spread, timing.offBy);
+    if (abs(timing.duration - expected) > 1e-9 || !(timing.spread <= tolerance) || !(timing.offBy <= tolerance)) {
+        errors++;
+    }
+    typedef Derivs_Limiter_T<double, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Basic_Features> Basic;
+    Basic basicA = Basic(100, 100, 100);
+    Basic basicB = Basic(50, 10, 400);
+    Basic basicC = Basic(1, 1, 1);
+    Basic* basicAxes[AXES] = { &basicA, &basicB, &basicC };
+    Timing basicTiming = runMove(basicAxes, targets);
+    if (basicTiming.duration != timing.duration || basicTiming.spread != timing.spread || basicTiming.offBy != timing.offBy) {
+        printf("  basic features limiters gave different timing: %g %g %g\n", basicTiming.duration, basicTiming.spread, basicTiming.offBy);
+        errors++;
+    }
+
+    double maxSpread = 0, maxOffBy = 0;
+    for (long m = 0; m < moves; m++) {
+        Derivs_Limiter_T<double> limiters[AXES];
+        for (int i = 0; i < AXES; i++) {
+            limiters[i] = Derivs_Limiter_T<double>(randomDouble(10, 300), randomDouble(1, 1000), randomDouble(1, 1000));
+            axes[i] = &limiters[i];
+            targets[i] = randomDouble(10, 200) * (randomDouble(0, 1) < 0.5 ? -1 : 1);
+        }
+        timing = runMove(axes, targets);
+        maxSpread = max(maxSpread, timing.spread);
+        maxOffBy = max(maxOffBy, timing.offBy);
+        if (!(timing.spread <= tolerance) || !(timing.offBy <= tolerance)) {
+            errors++;
+            if (errors <= 3) {
+                printf("  axes not together: duration=%g stopped %g apart, at most %g from duration\n", timing.duration, timing.spread, timing.offBy);
+                for (int i = 0; i < AXES; i++) {
+                    printf("    v=%g a=%g d=%g target=%g\n", limiters[i].getVelLimit(), limiters[i].getAccelLimit(), limiters[i].getDecelLimit(), targets[i]);
+                }
+            }
+        }
+    }
+    printf("%ld random moves of %d axes, dt %g s: axes stopped at most %.6f s apart, at most %.6f s from the time setTargets() returned\n", moves, AXES, dt, maxSpread, maxOffBy);
+    printf("errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,31 @@
+/**
+ * HostSimulation, runs Derivs_Limiter on a computer
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * This is the SmoothServo example with a simulated clock instead of a servo,
+ * time advances by exactly 10 milliseconds per loop so the output is the same every run.
+ * Prints csv: time,position,velocity,acceleration
+ */
+#include <Derivs_Limiter.h>
+#include <stdio.h>
+
+static unsigned long simulatedMicros = 1;
+static unsigned long getSimulatedMicros()
+{
+    return simulatedMicros;
+}
+
+int main()
+{
+    derivsLimiterSetMicrosSource(getSimulatedMicros);
+
+    Derivs_Limiter limiter = Derivs_Limiter(100, 100, 50); // velocityLimit, accelerationLimit, decelerationLimit
+    printf("time,position,velocity,acceleration\n");
+    for (int i = 0; i < 1000; i++) {
+        limiter.calc((millis() % 10000 < 5000) ? 0 : 180); // toggles every 5 seconds
+        printf("%.3f,%f,%f,%f\n", simulatedMicros / 1000000.0, limiter.getPosition(), limiter.getVelocity(), limiter.getAcceleration());
+        simulatedMicros += 10000;
+    }
+    derivsLimiterSetMicrosSource(NULL);
+    return 0;
+}
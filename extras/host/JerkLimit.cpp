@@ -0,0 +1,224 @@
+/**
+ * JerkLimit, checks the jerk limited (S-curve) calculation of Derivs_Limiter on random moves
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Each move starts from rest at 0 with random limits (velLimit 1 to 300, accelLimit and decelLimit 1 to 1000, jerkLimit 10 to 20000)
+ * and a random target (-200 to 200), and is calculated with a random time interval, either the same for every step or jittered (0.5 to 1.5 times).
+ * Half of the moves get a second random target partway through. Checks that
+ * - every move stops at its target (position == target and velocity == 0) in a reasonable time
+ * - speed never goes over velLimit
+ * - acceleration never changes faster than jerkLimit, including when the move arrives
+ * - acceleration stays within accelLimit and decelLimit * maxStoppingDecel
+ * - position doesn't go past the target (by more than a rounding error) when nothing was changed during the move
+ * The same is checked in velocity mode, with three random velocity targets in a row, each of which velocity has to reach exactly.
+ * Usage: JerkLimit [number of moves per range of time intervals]
+ * Prints a summary for each range of time intervals and returns 1 if anything was wrong.
+ */
+#include <Derivs_Limiter.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Jerk_Features> Limiter;
+
+static unsigned long seed = 1;
+static double randomDouble(double low, double high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+struct Result {
+    long unfinished;
+    long overVelocity;
+    long overJerk;
+    long overAccel;
+    long overshoot;
+    double maxVelRatio; // speed / velLimit
+    double maxJerkRatio; // change in accel / (jerkLimit * dt)
+    double maxOvershoot; // distance past the target / move distance
+};
+
+/**
+ * one move, returns true if it was all right
+ */
+static bool runMove(Result& r, double dtLow, double dtHigh, bool jitter, bool retarget)
+{
+    float velLimit = randomDouble(1, 300);
+    float accelLimit = randomDouble(1, 1000);
+    float decelLimit = randomDouble(1, 1000);
+    float jerkLimit = randomDouble(10, 20000);
+    float target = randomDouble(-200, 200);
+    float secondTarget = randomDouble(-200, 200);
+    double dt = randomDouble(dtLow, dtHigh);
+    const float maxStoppingDecel = 2;
+
+    Limiter l = Limiter(velLimit, accelLimit, decelLimit, target);
+    l.setJerkLimit(jerkLimit);
+    // generous bound on how long a move can take: the trapezoid, plus the time to ramp acceleration, for the longest distance
+    double bound = 400 / velLimit + velLimit / accelLimit + velLimit / decelLimit + 2 * accelLimit / jerkLimit + 2 * decelLimit / jerkLimit;
+    double maxTime = 3 * bound + 1;
+    double retargetTime = randomDouble(0, bound / 3);
+    bool pending = retarget;
+
+    bool ok = true;
+    bool velFail = false, jerkFail = false, accelFail = false, overshootFail = false;
+    float lastAccel = 0;
+    double t = 0;
+    bool finished = false;
+    while (t < maxTime) {
+        if (pending && t >= retargetTime) {
+            l.setTarget(secondTarget);
+            pending = false;
+        }
+        float d = jitter ? dt * randomDouble(0.5, 1.5) : dt;
+        l.step(d);
+        t += d;
+        float accel = l.getAcceleration();
+        double velRatio = abs(l.getVelocity()) / velLimit;
+        r.maxVelRatio = max(r.maxVelRatio, velRatio);
+        if (velRatio > 1 + 1e-5) {
+            velFail = true;
+        }
+        double jerkRatio = abs(accel - lastAccel) / (jerkLimit * d);
+        r.maxJerkRatio = max(r.maxJerkRatio, jerkRatio);
+        if (abs(accel - lastAccel) > jerkLimit * d * 1.001 + 1e-4) {
+            jerkFail = true;
+        }
+        if (abs(accel) > max(accelLimit, decelLimit * maxStoppingDecel) * 1.0001) {
+            accelFail = true;
+        }
+        lastAccel = accel;
+        if (!retarget) {
+            float past = (target >= 0) ? l.getPosition() - target : target - l.getPosition();
+            double distance = abs(target);
+            if (distance > 0 && past > 0) {
+                r.maxOvershoot = max(r.maxOvershoot, past / distance);
+                if (past > 1e-4 * distance + 1e-4) {
+                    overshootFail = true;
+                }
+            }
+        }
+        if (!pending && l.isPosAtTarget() && l.getVelocity() == 0) {
+            finished = true;
+            break;
+        }
+    }
+    if (!finished) {
+        r.unfinished++;
+        ok = false;
+        if (r.unfinished <= 3) {
+            printf("  didn't finish: v=%g a=%g d=%g j=%g target=%g dt=%g jitter=%d position=%g velocity=%g\n",
+                velLimit, accelLimit, decelLimit, jerkLimit, l.getTarget(), dt, jitter, l.getPosition(), l.getVelocity());
+        }
+    }
+    if (velFail) {
+        r.overVelocity++;
+        ok = false;
+    }
+    if (jerkFail) {
+        r.overJerk++;
+        ok = false;
+    }
+    if (accelFail) {
+        r.overAccel++;
+        ok = false;
+    }
+    if (overshootFail) {
+        r.overshoot++;
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * three velocity targets in a row in velocity mode, returns true if it was all right
+ */
+static bool runVelocityMove(Result& r, double dtLow, double dtHigh, bool jitter)
+{
+    float velLimit = randomDouble(1, 300);
+    float accelLimit = randomDouble(1, 1000);
+    float decelLimit = randomDouble(1, 1000);
+    float jerkLimit = randomDouble(10, 20000);
+    double dt = randomDouble(dtLow, dtHigh);
+
+    Limiter l = Limiter(velLimit, accelLimit, decelLimit);
+    l.setJerkLimit(jerkLimit);
+    double maxTime = 3 * (2 * velLimit / min(accelLimit, decelLimit) + 2 * max(accelLimit, decelLimit) / jerkLimit) + 1;
+    bool velFail = false, jerkFail = false, unfinished = false;
+    float lastAccel = 0;
+    for (int n = 0; n < 3; n++) {
+        float velTarget = randomDouble(-1.2 * velLimit, 1.2 * velLimit); // sometimes past velLimit
+        l.setVelTarget(velTarget);
+        bool reached = false;
+        for (double t = 0; t < maxTime;) {
+            float d = jitter ? dt * randomDouble(0.5, 1.5) : dt;
+            l.step(d);
+            t += d;
+            float accel = l.getAcceleration();
+            double velRatio = abs(l.getVelocity()) / velLimit;
+            r.maxVelRatio = max(r.maxVelRatio, velRatio);
+            if (velRatio > 1 + 1e-5) {
+                velFail = true;
+            }
+            r.maxJerkRatio = max(r.maxJerkRatio, (double)(abs(accel - lastAccel) / (jerkLimit * d)));
+            if (abs(accel - lastAccel) > jerkLimit * d * 1.001 + 1e-4) {
+                jerkFail = true;
+            }
+            lastAccel = accel;
+            if (l.getVelocity() == constrain(velTarget, -velLimit, velLimit) && accel == 0) {
+                reached = true;
+                break;
+            }
+        }
+        if (!reached) {
+            unfinished = true;
+            break;
+        }
+    }
+    if (unfinished) {
+        r.unfinished++;
+        if (r.unfinished <= 3) {
+            printf("  didn't reach velocity target: v=%g a=%g d=%g j=%g velTarget=%g dt=%g jitter=%d velocity=%g\n",
+                velLimit, accelLimit, decelLimit, jerkLimit, l.getVelTarget(), dt, jitter, l.getVelocity());
+        }
+    }
+    if (velFail) {
+        r.overVelocity++;
+    }
+    if (jerkFail) {
+        r.overJerk++;
+    }
+    return !unfinished && !velFail && !jerkFail;
+}
+
+int main(int argc, char** argv)
+{
+    long moves = 2000;
+    if (argc > 1) {
+        moves = atol(argv[1]);
+    }
+    const double ranges[][2] = { { 0.0001, 0.001 }, { 0.001, 0.01 } };
+    int errors = 0;
+    for (int range = 0; range < 2; range++) {
+        Result r = Result();
+        seed = range + 1;
+        for (long i = 0; i < moves; i++) {
+            if (!runMove(r, ranges[range][0], ranges[range][1], i % 2 == 1, i % 4 >= 2)) {
+                errors++;
+            }
+        }
+        printf("position mode, dt %g to %g s, %ld moves: unfinished %ld, over velLimit %ld (max %.6f), over jerkLimit %ld (max %.4f), over accel limits %ld, overshoot %ld (max %.2e)\n",
+            ranges[range][0], ranges[range][1], moves, r.unfinished, r.overVelocity, r.maxVelRatio, r.overJerk, r.maxJerkRatio, r.overAccel, r.overshoot, r.maxOvershoot);
+
+        r = Result();
+        for (long i = 0; i < moves; i++) {
+            if (!runVelocityMove(r, ranges[range][0], ranges[range][1], i % 2 == 1)) {
+                errors++;
+            }
+        }
+        printf("velocity mode, dt %g to %g s, %ld moves: unfinished %ld, over velLimit %ld (max %.6f), over jerkLimit %ld (max %.4f)\n",
+            ranges[range][0], ranges[range][1], moves, r.unfinished, r.overVelocity, r.maxVelRatio, r.overJerk, r.maxJerkRatio);
+    }
+    printf("errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * MailboxStress, checks Derivs_Limiter_Mailbox with one thread posting commands as fast as it can while another runs step()
+ * https://github.com/joshua-8/Derivs_Limiter
+ * Every command is made from one counter (target = k, velLimit = k + 1, accelLimit = k + 2, decelLimit = k + 3),
+ * so a command that was mixed up with another one, or an older command arriving after a newer one, can be seen.
+ * Built with -fsanitize=thread, ThreadSanitizer should report no data race (it warns that it doesn't follow the fences, which only order the relaxed atomics).
+ * Usage: MailboxStress [number of commands]
+ * Prints a summary and returns 1 if anything was wrong.
+ */
+#include <Derivs_Limiter_Mailbox.h>
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+int main(int argc, char** argv)
+{
+    long commands = 2000000;
+    if (argc > 1) {
+        commands = atol(argv[1]);
+    }
+    if (commands <= 0 || commands > 16000000) { // k + 3 has to be exact as a float
+        fprintf(stderr, "number of commands must be 1 to 16000000\n");
+        return 2;
+    }
+
+    Derivs_Limiter_Mailbox mailbox;
+    Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Mailbox_Features> limiter = Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Mailbox_Features>(1, 1);
+    limiter.setMailbox(&mailbox);
+    std::atomic<bool> done(false);
+
+    std::thread producer([&]() {
+        for (long k = 1; k <= commands; k++) {
+            Derivs_Limiter_Command command;
+            command.target = k;
+            command.velLimit = k + 1;
+            command.accelLimit = k + 2;
+            command.decelLimit = k + 3;
+            mailbox.post(command);
+            if (k % 64 == 0) {
+                std::this_thread::yield(); // leave gaps, or the consumer mostly sees a command being written
+            }
+        }
+        done.store(true);
+    });
+
+    long steps = 0;
+    long changes = 0;
+    long errors = 0;
+    float lastK = 0;
+    bool finished = false;
+    while (!finished) {
+        finished = done.load(); // one more step after the producer is done, to take the last command
+        limiter.step(0.0001);
+        steps++;
+        float k = limiter.getTarget();
+        if (k == lastK) {
+            continue;
+        }
+        changes++;
+        if (k < lastK || limiter.getVelLimit() != k + 1 || limiter.getAccelLimit() != k + 2 || limiter.getDecelLimit() != k + 3) {
+            if (errors < 10) {
+                printf("bad command after %.0f: target %.0f velLimit %.0f accelLimit %.0f decelLimit %.0f\n",
+                    lastK, k, limiter.getVelLimit(), limiter.getAccelLimit(), limiter.getDecelLimit());
+            }
+            errors++;
+        }
+        lastK = k;
+    }
+    producer.join();
+
+    if (lastK != commands) {
+        printf("last command was not taken, target is %.0f\n", lastK);
+        errors++;
+    }
+    printf("commands,%ld\nsteps,%ld\ncommands taken,%ld\nerrors,%ld\n", commands, steps, changes, errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+/**
+ * ParallelStep, steps many Derivs_Limiters (and Derivs_Limiter_Compacts, and the channels of a Derivs_Limiter_Bank) with Derivs_Limiter_Parallel
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Every item is stepped twice, once in order on one thread and once with Derivs_Limiter_Parallel,
+ * with new targets every 100 ticks. The two results must be bit-identical.
+ * Usage: ParallelStep [workers] [ticks]
+ * Prints csv: name,value and returns 1 if the results differ.
+ */
+#include <Derivs_Limiter_Bank.h>
+#include <Derivs_Limiter_Compact.h>
+#include <Derivs_Limiter_Parallel.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+static const size_t count = 4096;
+static const float dt = 0.001;
+
+static Derivs_Limiter serialLimiters[count];
+static Derivs_Limiter parallelLimiters[count];
+static Derivs_Limiter_Shared_Limits compactLimits = Derivs_Limiter_Shared_Limits(50, 50);
+static Derivs_Limiter_Compact serialCompacts[count];
+static Derivs_Limiter_Compact parallelCompacts[count];
+static Derivs_Limiter_Bank<count> serialBank;
+static Derivs_Limiter_Bank<count> parallelBank;
+
+static unsigned long seed = 1;
+static float randomFloat(float low, float high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0f;
+}
+
+static void idle()
+{
+    std::this_thread::yield();
+}
+
+template <typename Items>
+static double runParallel(Derivs_Limiter_Parallel<Items>& parallel, size_t ticks)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::thread threads[8];
+    for (size_t w = 1; w < parallel.getWorkers(); w++) {
+        threads[w] = std::thread(&Derivs_Limiter_Parallel<Items>::run, &parallel, w, ticks, dt);
+    }
+    parallel.run(0, ticks, dt);
+    for (size_t w = 1; w < parallel.getWorkers(); w++) {
+        threads[w].join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    size_t workers = std::thread::hardware_concurrency();
+    size_t ticks = 2000;
+    if (argc > 1) {
+        workers = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        ticks = atoi(argv[2]);
+    }
+    workers = constrain(workers, (size_t)1, (size_t)8);
+
+    for (size_t i = 0; i < count; i++) {
+        float velLimit = randomFloat(1, 100);
+        float accelLimit = randomFloat(1, 100);
+        float decelLimit = randomFloat(1, 100);
+        serialLimiters[i].setVelAccelLimits(velLimit, accelLimit, decelLimit);
+        parallelLimiters[i].setVelAccelLimits(velLimit, accelLimit, decelLimit);
+        serialBank.setVelAccelLimits(i, velLimit, accelLimit, decelLimit);
+        parallelBank.setVelAccelLimits(i, velLimit, accelLimit, decelLimit);
+        serialCompacts[i].setLimits(&compactLimits);
+        parallelCompacts[i].setLimits(&compactLimits);
+    }
+
+    Derivs_Limiter_Array<> array = Derivs_Limiter_Array<>(parallelLimiters, count);
+    Derivs_Limiter_Parallel<Derivs_Limiter_Array<> > parallel(&array, workers, 64, idle);
+    Derivs_Limiter_Array<Derivs_Limiter_Compact> compactArray = Derivs_Limiter_Array<Derivs_Limiter_Compact>(parallelCompacts, count);
+    Derivs_Limiter_Parallel<Derivs_Limiter_Array<Derivs_Limiter_Compact> > parallelCompact(&compactArray, workers, 64, idle);
+    Derivs_Limiter_Parallel<Derivs_Limiter_Bank<count> > parallelBank2(&parallelBank, workers, 64, idle);
+
+    double serialTime = 0;
+    double parallelTime = 0;
+    double serialCompactTime = 0;
+    double parallelCompactTime = 0;
+    double serialBankTime = 0;
+    double parallelBankTime = 0;
+    for (size_t done = 0; done < ticks; done += 100) {
+        size_t batch = min(ticks - done, (size_t)100);
+        for (size_t i = 0; i < count; i++) {
+            float target = randomFloat(-100, 100);
+            serialLimiters[i].setTarget(target);
+            parallelLimiters[i].setTarget(target);
+            serialCompacts[i].setTarget(target);
+            parallelCompacts[i].setTarget(target);
+            if (i % 5 == 0) {
+                serialBank.setVelTarget(i, target / 4);
+                parallelBank.setVelTarget(i, target / 4);
+            } else {
+                serialBank.setTarget(i, target);
+                parallelBank.setTarget(i, target);
+            }
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < batch; t++) {
+            for (size_t i = 0; i < count; i++) {
+                serialLimiters[i].step(dt);
+            }
+        }
+        serialTime += seconds(start);
+        parallelTime += runParallel(parallel, batch);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < batch; t++) {
+            for (size_t i = 0; i < count; i++) {
+                serialCompacts[i].step(dt);
+            }
+        }
+        serialCompactTime += seconds(start);
+        parallelCompactTime += runParallel(parallelCompact, batch);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < batch; t++) {
+            serialBank.step(dt);
+        }
+        serialBankTime += seconds(start);
+        parallelBankTime += runParallel(parallelBank2, batch);
+    }
+
+    size_t differences = 0;
+    for (size_t i = 0; i < count; i++) {
+        float a[3] = { serialLimiters[i].getPosition(), serialLimiters[i].getVelocity(), serialLimiters[i].getAcceleration() };
+        float b[3] = { parallelLimiters[i].getPosition(), parallelLimiters[i].getVelocity(), parallelLimiters[i].getAcceleration() };
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            differences++;
+        }
+        float c[2] = { serialCompacts[i].getPosition(), serialCompacts[i].getVelocity() };
+        float d[2] = { parallelCompacts[i].getPosition(), parallelCompacts[i].getVelocity() };
+        if (memcmp(c, d, sizeof(c)) != 0) {
+            differences++;
+        }
+    }
+    if (memcmp(serialBank.getPositions(), parallelBank.getPositions(), sizeof(float) * count) != 0
+        || memcmp(serialBank.getVelocities(), parallelBank.getVelocities(), sizeof(float) * count) != 0) {
+        differences++;
+    }
+
+    printf("name,value\n");
+    printf("items,%zu\nworkers,%zu\nticks,%zu\n", count, workers, ticks);
+    printf("serial limiters ns per step,%.2f\n", serialTime * 1e9 / (ticks * count));
+    printf("parallel limiters ns per step,%.2f\n", parallelTime * 1e9 / (ticks * count));
+    printf("serial compact ns per step,%.2f\n", serialCompactTime * 1e9 / (ticks * count));
+    printf("parallel compact ns per step,%.2f\n", parallelCompactTime * 1e9 / (ticks * count));
+    printf("serial bank ns per step,%.2f\n", serialBankTime * 1e9 / (ticks * count));
+    printf("parallel bank ns per step,%.2f\n", parallelBankTime * 1e9 / (ticks * count));
+    printf("differences,%zu\n", differences);
+    return differences ? 1 : 0;
+}
@@ -0,0 +1,278 @@
+/**
+ * ProfileFollow, checks a Derivs_Limiter following a Derivs_Limiter_Profile set with setProfile() on random moves
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Each move has random limits (velLimit 1 to 300, accelLimit and decelLimit 1 to 1000), a random target (-200 to 200), and is calculated with a random
+ * time interval (0.5 to 5 ms), jittered (0.5 to 1.5 times) for half of the moves. Checks that
+ * - a move from rest is where profile.evaluate() says it is at the time since the move started, and that the step that goes past getDuration() puts
+ *   position exactly on the target with velocity 0 (the snap at the end of the profile)
+ * - a new target partway through a move is planned again from where the move was and followed the same way, if it can be (moving towards the new target
+ *   and slow enough to stop before it), and otherwise isn't followed and is the same, bit for bit, as a copy of the limiter without a profile
+ * - changing position, velocity, velLimit, accelLimit or decelLimit partway through a move stops following the profile, and from then on the move is
+ *   the same, bit for bit, as a copy of the limiter without a profile
+ * - a move that can't be planned (moving away from the target, faster than velLimit, or too fast to stop before it) is never followed, and is the same,
+ *   bit for bit, as the limiter without a profile
+ * - a 100 second move calculated every 0.1 ms with float still arrives within an interval of getDuration() (the time since the move started doesn't drift)
+ * Usage: ProfileFollow [number of moves for each check]
+ * Prints a summary for each check and returns 1 if anything was wrong.
+ */
+#include <Derivs_Limiter.h>
+#include <Derivs_Limiter_Profile.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Profile_Features> Limiter;
+
+static unsigned long seed = 1;
+static double randomDouble(double low, double high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+struct Check {
+    const char* name;
+    long moves;
+    long errors;
+    double maxError; // largest distance from the profile, as a fraction of the move distance
+};
+
+static void fail(Check& c, const char* what, Limiter& l)
+{
+    if (++c.errors <= 3) {
+        printf("  %s: %s, v=%g a=%g d=%g target=%g position=%g velocity=%g\n",
+            c.name, what, l.getVelLimit(), l.getAccelLimit(), l.getDecelLimit(), l.getTarget(), l.getPosition(), l.getVelocity());
+    }
+}
+
+struct Move {
+    float velLimit;
+    float accelLimit;
+    float decelLimit;
+    double dt;
+    bool jitter;
+    float interval() { return jitter ? dt * randomDouble(0.5, 1.5) : dt; }
+};
+
+static Move randomMove()
+{
+    Move m;
+    m.velLimit = randomDouble(1, 300);
+    m.accelLimit = randomDouble(1, 1000);
+    m.decelLimit = randomDouble(1, 1000);
+    m.dt = randomDouble(0.0005, 0.005);
+    m.jitter = randomDouble(0, 1) < 0.5;
+    return m;
+}
+
+/**
+ * steps l until the profile it follows ends, checking it against ref (planned the same way) on every step and that it stops exactly at the target
+ * @param  stopAt: seconds into the move to return early at, still following, INFINITY to follow to the end
+ * @retval (bool) true if it was all right
+ */
+static bool follow(Check& c, Limiter& l, Derivs_Limiter_Profile_T<float>& profile, Move& m, double stopAt = INFINITY)
+{
+    Derivs_Limiter_Profile_T<float> ref;
+    float start = l.getPosition();
+    if (!ref.plan(start, l.getVelocity(), l.getTarget(), m.velLimit, m.accelLimit, m.decelLimit)) {
+        fail(c, "couldn't plan the reference", l);
+        return false;
+    }
+    double duration = ref.getDuration();
+    double distance = abs(l.getTarget() - start);
+    double t = 0;
+    while (t < stopAt) {
+        float d = m.interval();
+        l.step(d);
+        t += d;
+        float pos, vel, acc;
+        bool moving = ref.evaluate(t, pos, vel, acc);
+        if (!moving || t >= duration) {
+            // the snap: the step that goes past the end puts position exactly on the target
+            if (t < duration - 1e-5 * duration - 1e-6 || (moving && profile.isActive())) {
+                fail(c, "followed past the end of the profile", l);
+                return false;
+            }
+            if (l.getPosition() != l.getTarget() || l.getVelocity() != 0 || profile.isActive()) {
+                fail(c, "didn't stop exactly at the target", l);
+                return false;
+            }
+            return true;
+        }
+        if (!profile.isActive()) {
+            fail(c, "stopped following the profile", l);
+            return false;
+        }
+        double error = abs(l.getPosition() - pos) / distance;
+        c.maxError = max(c.maxError, error);
+        if (abs(l.getPosition() - pos) > 1e-5 * (abs(start) + abs(l.getTarget()) + m.velLimit * duration + 1)) {
+            fail(c, "not where the profile is", l);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * steps a and b (b has no profile) until a stops at its target or for a generous time, checking they're the same bit for bit
+ */
+static bool sameAsNormal(Check& c, Limiter& a, Limiter& b, Derivs_Limiter_Profile_T<float>& profile, Move& m)
+{
+    double maxTime = 3 * (400 / m.velLimit + m.velLimit / m.accelLimit + m.velLimit / m.decelLimit + 2 * sqrt(400 / m.decelLimit)) + 1;
+    for (double t = 0; t < maxTime;) {
+        float d = m.interval();
+        a.step(d);
+        b.step(d);
+        t += d;
+        if (profile.isActive()) {
+            fail(c, "followed the profile", a);
+            return false;
+        }
+        if (a.getPosition() != b.getPosition() || a.getVelocity() != b.getVelocity()) {
+            fail(c, "different from the normal calculation", a);
+            return false;
+        }
+        if (a.isPosAtTarget() && a.getVelocity() == 0) {
+            return true;
+        }
+    }
+    return true; // with float and a very low decelLimit, the normal calculation can be left creeping towards the target by less than the rounding of position
+}
+
+static void fromRest(Check& c)
+{
+    Move m = randomMove();
+    Limiter l = Limiter(m.velLimit, m.accelLimit, m.decelLimit, randomDouble(-200, 200));
+    Derivs_Limiter_Profile_T<float> profile;
+    l.setProfile(&profile);
+    if (l.getTarget() != 0) {
+        follow(c, l, profile, m);
+    }
+}
+
+static void newTarget(Check& c)
+{
+    Move m = randomMove();
+    Limiter l = Limiter(m.velLimit, m.accelLimit, m.decelLimit, randomDouble(-200, 200));
+    Derivs_Limiter_Profile_T<float> profile;
+    l.setProfile(&profile);
+    if (l.getTarget() == 0) {
+        return;
+    }
+    Derivs_Limiter_Profile_T<float> first;
+    first.plan(0, 0, l.getTarget(), m.velLimit, m.accelLimit, m.decelLimit);
+    if (!follow(c, l, profile, m, randomDouble(0, first.getDuration()))) {
+        return;
+    }
+    float target = randomDouble(-200, 200);
+    l.setTarget(target);
+    float toTarget = target - l.getPosition();
+    float towards = (toTarget > 0) ? l.getVelocity() : -l.getVelocity();
+    if (toTarget != 0 && towards >= 0 && towards <= m.velLimit && sq(towards) <= 2 * m.decelLimit * abs(toTarget)) {
+        follow(c, l, profile, m);
+    } else {
+        Limiter normal = l;
+        normal.setProfile(NULL);
+        sameAsNormal(c, l, normal, profile, m);
+    }
+}
+
+static void changed(Check& c)
+{
+    Move m = randomMove();
+    Limiter l = Limiter(m.velLimit, m.accelLimit, m.decelLimit, randomDouble(-200, 200));
+    Derivs_Limiter_Profile_T<float> profile;
+    l.setProfile(&profile);
+    if (l.getTarget() == 0) {
+        return;
+    }
+    Derivs_Limiter_Profile_T<float> first;
+    first.plan(0, 0, l.getTarget(), m.velLimit, m.accelLimit, m.decelLimit);
+    if (!follow(c, l, profile, m, randomDouble(0.05, 0.95) * first.getDuration()) || !profile.isActive()) {
+        return; // a short move can end before stopAt
+    }
+    switch ((int)randomDouble(0, 4.999)) {
+    case 0:
+        l.setPosition(l.getPosition() + randomDouble(-1, 1));
+        break;
+    case 1:
+        l.setVelocity(l.getVelocity() * randomDouble(0, 1));
+        break;
+    case 2:
+        l.setVelLimit(m.velLimit *= randomDouble(0.5, 1.5));
+        break;
+    case 3:
+        l.setAccelLimit(m.accelLimit *= randomDouble(0.5, 1.5));
+        break;
+    default:
+        l.setDecelLimit(m.decelLimit *= randomDouble(0.5, 1.5));
+        break;
+    }
+    Limiter normal = l;
+    normal.setProfile(NULL);
+    sameAsNormal(c, l, normal, profile, m);
+}
+
+static void unplannable(Check& c)
+{
+    Move m = randomMove();
+    float target = randomDouble(-200, 200);
+    float direction = (target > 0) ? 1 : -1;
+    float velocity;
+    switch ((int)randomDouble(0, 2.999)) {
+    case 0: // away from the target
+        velocity = -direction * randomDouble(0.01, 1) * m.velLimit;
+        break;
+    case 1: // faster than velLimit
+        velocity = direction * randomDouble(1.01, 2) * m.velLimit;
+        break;
+    default: // too fast to stop before the target
+        velocity = direction * sqrt(2 * m.decelLimit * abs(target)) * randomDouble(1.01, 1.5);
+        break;
+    }
+    Limiter l = Limiter(m.velLimit, m.accelLimit, m.decelLimit, target, 0, velocity);
+    Derivs_Limiter_Profile_T<float> profile;
+    l.setProfile(&profile);
+    Limiter normal = Limiter(m.velLimit, m.accelLimit, m.decelLimit, target, 0, velocity);
+    sameAsNormal(c, l, normal, profile, m);
+}
+
+static void longMove(Check& c)
+{
+    Move m = randomMove();
+    m.velLimit = randomDouble(0.5, 2);
+    m.dt = 0.0001;
+    float target = (randomDouble(0, 1) < 0.5 ? -1 : 1) * 100 * m.velLimit;
+    Limiter l = Limiter(m.velLimit, m.accelLimit, m.decelLimit, target);
+    Derivs_Limiter_Profile_T<float> profile;
+    l.setProfile(&profile);
+    follow(c, l, profile, m);
+}
+
+int main(int argc, char** argv)
+{
+    long moves = 2000;
+    if (argc > 1) {
+        moves = atol(argv[1]);
+    }
+    Check checks[] = {
+        { "from rest", 0, 0, 0 },
+        { "new target partway", 0, 0, 0 },
+        { "changed partway", 0, 0, 0 },
+        { "can't be planned", 0, 0, 0 },
+        { "100 s at 0.1 ms", 0, 0, 0 },
+    };
+    void (*runs[])(Check&) = { fromRest, newTarget, changed, unplannable, longMove };
+    long errors = 0;
+    for (int i = 0; i < 5; i++) {
+        long n = (i == 4) ? max(moves / 200, 1L) : moves; // a million steps each
+        for (long j = 0; j < n; j++) {
+            checks[i].moves++;
+            runs[i](checks[i]);
+        }
+        printf("%s, %ld moves: errors %ld, max distance from the profile %.2e of the move\n", checks[i].name, checks[i].moves, checks[i].errors, checks[i].maxError);
+        errors += checks[i].errors;
+    }
+    printf("errors: %ld\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * StepperPulses, checks Derivs_Limiter_Stepper against the motion of the Derivs_Limiter it follows
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Time is simulated (ticks are microseconds): the loop calls refill() every millisecond, and a simulated timer interrupt
+ * takes each pulse when it's due and keeps count of the steps, the way a stepper driver would.
+ * Checks that
+ * - while the queue doesn't run empty, the step count at every pulse is the reference limiter's position * stepsPerUnit (rounded),
+ *   where the reference is a Derivs_Limiter with the same settings stepped with the same planStep
+ * - the step count ends at every target, including when the target is changed in the middle of a move and during a pause in refill() calls
+ * - with a limiter on a millisecond clock (ticksPerSecond 1000), refill() stays lookahead seconds ahead of that clock
+ * Prints a summary and returns 1 if anything was wrong.
+ */
+#include <Derivs_Limiter_Stepper.h>
+#include <stdio.h>
+#include <vector>
+
+static unsigned long simMicros = 1;
+static unsigned long simulatedMicros()
+{
+    return simMicros;
+}
+
+struct Millis_Clock {
+    static const unsigned long ticksPerSecond = 1000;
+    static unsigned long now()
+    {
+        return simMicros / 1000;
+    }
+};
+
+/**
+ * refill() every millisecond for 100 ms on a millisecond clock, nothing is taken from the queue, returns the number of errors
+ */
+static int millisecondClock()
+{
+    typedef Derivs_Limiter_T<float, Millis_Clock> Limiter;
+    const float planStep = 0.001;
+    Limiter limiter = Limiter(50, 200, NAN, 30);
+    Derivs_Limiter_Stepper<4096, Limiter> stepper(&limiter, 200, 1000000, planStep, 0.02);
+    for (int ms = 0; ms < 100; ms++) {
+        stepper.refill();
+        simMicros += 1000;
+    }
+    // the last refill() was 99 ms after the first, so it should have calculated 99 ms plus lookahead (give or take one planStep of rounding)
+    Limiter reference = Limiter(50, 200, NAN, 30);
+    int calculated = 0;
+    while (reference.getPosition() != limiter.getPosition() && calculated < 1000) {
+        reference.step(planStep);
+        calculated++;
+    }
+    if (calculated < 118 || calculated > 120) {
+        printf("millisecond clock: calculated %d ms ahead, not 119\n", calculated);
+        return 1;
+    }
+    return 0;
+}
+
+struct Interrupt {
+    long count;
+    bool waiting; // has a pulse that is due at dueMicros
+    bool ranEmpty; // found the queue empty
+    unsigned long dueMicros;
+    unsigned long lastFire;
+    unsigned long tick; // generator time of the waiting pulse, sum of intervals since the start
+    Derivs_Limiter_Stepper_Pulse pulse;
+};
+
+int main()
+{
+    derivsLimiterSetMicrosSource(simulatedMicros);
+    const float stepsPerUnit = 200;
+    const float planStep = 0.001;
+    const float velLimit = 50; // 10000 steps per second
+    const float accelLimit = 200;
+    Derivs_Limiter limiter = Derivs_Limiter(velLimit, accelLimit);
+    Derivs_Limiter reference = Derivs_Limiter(velLimit, accelLimit);
+    Derivs_Limiter_Stepper<128> stepper(&limiter, stepsPerUnit, 1000000, planStep, 0.02);
+
+    // reference step counts for the first move, one for each planStep
+    limiter.setTarget(30);
+    reference.setTarget(30);
+    std::vector<float> referenceSteps(1, 0);
+    while (!reference.isIdle()) {
+        reference.step(planStep);
+        referenceSteps.push_back(reference.getPosition() * stepsPerUnit);
+    }
+
+    Interrupt isr = Interrupt();
+    isr.ranEmpty = true;
+    int errors = 0;
+    double maxReferenceError = 0;
+    unsigned long pulses = 0;
+    unsigned long minInterval = (unsigned long)-1;
+    int phase = 0;
+    unsigned long phaseStart = 0;
+    for (unsigned long ms = 0; ms < 20000; ms++) {
+        if (phase == 0 && limiter.isIdle() && stepper.available() == 0 && !isr.waiting) {
+            if (isr.count != 6000) {
+                printf("move 1 ended at %ld steps, not 6000\n", isr.count);
+                errors++;
+            }
+            limiter.setTarget(-40);
+            phase = 1;
+            phaseStart = ms;
+        } else if (phase == 1 && ms == phaseStart + 700) {
+            limiter.setTarget(10); // in the middle of the move, turns around
+            phase = 2;
+        } else if (phase == 2 && limiter.isIdle() && stepper.available() == 0 && !isr.waiting) {
+            if (isr.count != 2000) {
+                printf("move 2 ended at %ld steps, not 2000\n", isr.count);
+                errors++;
+            }
+            phase = 3;
+            break;
+        }
+        bool paused = (phase == 1 && ms >= phaseStart + 300 && ms < phaseStart + 350); // the queue runs empty, the move carries on afterwards
+        if (!paused) {
+            stepper.refill();
+        }
+
+        // the interrupt, for each microsecond of this millisecond
+        for (unsigned long us = 0; us < 1000; us++) {
+            simMicros++;
+            if (!isr.waiting) {
+                if (stepper.take(isr.pulse)) {
+                    isr.waiting = true;
+                    isr.dueMicros = (isr.ranEmpty ? simMicros : isr.lastFire) + isr.pulse.interval;
+                    isr.tick += isr.pulse.interval;
+                    isr.ranEmpty = false;
+                } else {
+                    isr.ranEmpty = true;
+                }
+            }
+            while (isr.waiting && (long)(simMicros - isr.dueMicros) >= 0) {
+                isr.count += isr.pulse.forward ? 1 : -1;
+                isr.lastFire = isr.dueMicros;
+                isr.waiting = false;
+                pulses++;
+                if (isr.pulse.interval > 0) {
+                    minInterval = min(minInterval, isr.pulse.interval);
+                }
+                if (phase == 0) {
+                    float t = isr.tick / 1000000.0f / planStep; // in planSteps
+                    size_t i = (size_t)t;
+                    if (i + 1 < referenceSteps.size()) {
+                        float expected = referenceSteps[i] + (referenceSteps[i + 1] - referenceSteps[i]) * (t - i);
+                        double error = abs(isr.count - expected);
+                        maxReferenceError = max(maxReferenceError, error);
+                        if (error > 0.51) {
+                            errors++;
+                        }
+                    }
+                }
+                if (stepper.take(isr.pulse)) { // the next pulse, timed from this one
+                    isr.waiting = true;
+                    isr.dueMicros = isr.lastFire + isr.pulse.interval;
+                    isr.tick += isr.pulse.interval;
+                } else {
+                    isr.ranEmpty = true;
+                }
+            }
+        }
+    }
+    if (phase != 3) {
+        printf("moves didn't finish\n");
+        errors++;
+    }
+    if (stepper.getStepPosition() != isr.count) {
+        printf("getStepPosition() %ld, interrupt counted %ld\n", stepper.getStepPosition(), isr.count);
+        errors++;
+    }
+    errors += millisecondClock();
+    printf("pulses: %lu, shortest interval: %lu us, largest difference from reference: %.3f steps, errors: %d\n", pulses, minInterval, maxReferenceError, errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * TimeToTarget, checks getTimeToTarget() and getTimeToStop() against running the calculation until it arrives
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Each state has random limits (velLimit 1 to 300, accelLimit and decelLimit 1 to 1000, some maxStoppingDecel, preventGoingWrongWay and preventGoingTooFast),
+ * a random position and target (-100 to 100) and a random velocity (up to 1.5 times velLimit either way, so some go the wrong way or too fast).
+ * getTimeToTarget() is compared with the time a copy takes with step(0.0001) until it stops at the target,
+ * and getTimeToStop() with the time a copy in velocity mode with a velocity target of 0 takes to stop.
+ * getTimeToTarget() has to be within 40 steps (4 ms) of the simulated time: the calculation's last approach to the target takes between about 3 and 38 steps
+ * longer than braking at decelLimit, at any time interval.
+ * States that can't stop in time even braking at maxStoppingDecel pass the target and come back. The calculation starts braking up to a step's distance (speed * dt)
+ * away from where braking continuously would, which changes how far past the target it goes, most near the edge, where passing speed is the square root of something close to 0.
+ * These are counted separately and also allowed the difference getTimeToTarget() gives for starting a step's distance closer to or further from the target.
+ * The one case getTimeToTarget() doesn't support is passing the target with preventGoingWrongWay: it gives the time until passing the target, and the way back
+ * from wherever the last step stopped depends on the time interval. Those states are only checked not to arrive before that time, and counted separately.
+ * Uses Derivs_Limiter_T<double> so the differences are from the formulas and the time interval, not from rounding.
+ * Usage: TimeToTarget [number of states]
+ * Prints a summary and returns 1 if any difference is over its tolerance.
+ */
+#include <Derivs_Limiter.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef Derivs_Limiter_T<double> Limiter;
+
+static const double dt = 0.0001;
+static const double tolerance = 40 * dt;
+
+static unsigned long seed = 1;
+static double randomDouble(double low, double high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+struct Result {
+    long states;
+    long errors;
+    double maxError; // seconds
+    double maxRelativeError; // error / simulated time
+};
+
+static void add(Result& r, double predicted, double simulated, double tolerance)
+{
+    double error = abs(predicted - simulated);
+    r.states++;
+    r.maxError = max(r.maxError, error);
+    if (simulated > 0) {
+        r.maxRelativeError = max(r.maxRelativeError, error / simulated);
+    }
+    if (!(error <= tolerance)) { // also catches NAN
+        r.errors++;
+    }
+}
+
+/**
+ * steps a copy until it stops at the target, returns the time that took or INFINITY if it didn't within maxTime
+ */
+static double simulateArrival(Limiter l, double maxTime)
+{
+    for (double t = 0; t < maxTime; t += dt) {
+        if (l.isPosAtTarget() && l.getVelocity() == 0) {
+            return t;
+        }
+        l.step(dt);
+    }
+    return INFINITY;
+}
+
+/**
+ * steps a copy in velocity mode until velocity is 0
+ */
+static double simulateStop(Limiter l, double maxTime)
+{
+    l.setVelTarget(0);
+    for (double t = 0; t < maxTime; t += dt) {
+        if (l.getVelocity() == 0) {
+            return t;
+        }
+        l.step(dt);
+    }
+    return INFINITY;
+}
+
+int main(int argc, char** argv)
+{
+    long states = 2000;
+    if (argc > 1) {
+        states = atol(argv[1]);
+    }
+    Result normal = Result();
+    Result passing = Result();
+    Result unsupported = Result(); // passing the target with preventGoingWrongWay
+    Result stopping = Result();
+    for (long i = 0; i < states; i++) {
+        double velLimit = randomDouble(1, 300);
+        double accelLimit = randomDouble(1, 1000);
+        double decelLimit = randomDouble(1, 1000);
+        double maxStoppingDecel = (i % 3 == 0) ? randomDouble(1, 4) : 2;
+        double target = randomDouble(-100, 100);
+        double position = randomDouble(-100, 100);
+        double velocity = randomDouble(-1.5, 1.5) * velLimit;
+        bool preventGoingWrongWay = (i % 4 == 1);
+        bool preventGoingTooFast = (i % 5 == 2);
+        Limiter l = Limiter(velLimit, accelLimit, decelLimit, target, position, velocity, preventGoingWrongWay, preventGoingTooFast, -INFINITY, INFINITY, maxStoppingDecel);
+
+        double predicted = l.getTimeToTarget();
+        double simulated = simulateArrival(l, 2 * predicted + 10);
+        double speed = (target >= position) ? velocity : -velocity;
+        if (preventGoingTooFast) {
+            speed = constrain(speed, -velLimit, velLimit);
+        }
+        long errors = normal.errors + passing.errors + unsupported.errors;
+        bool passes = speed > 0 && sq(speed) / 2 / (decelLimit * maxStoppingDecel) > abs(target - position);
+        if (passes && preventGoingWrongWay) {
+            unsupported.states++;
+            unsupported.maxError = max(unsupported.maxError, simulated - predicted);
+            if (!(simulated >= predicted - tolerance)) {
+                unsupported.errors++;
+            }
+        } else if (passes) {
+            // what getTimeToTarget() gives if braking started a step's distance sooner or later
+            double shift = (target >= position ? 1 : -1) * speed * dt;
+            double sooner = Limiter(velLimit, accelLimit, decelLimit, target, position + shift, velocity, preventGoingWrongWay, preventGoingTooFast, -INFINITY, INFINITY, maxStoppingDecel).getTimeToTarget();
+            double later = Limiter(velLimit, accelLimit, decelLimit, target, position - shift, velocity, preventGoingWrongWay, preventGoingTooFast, -INFINITY, INFINITY, maxStoppingDecel).getTimeToTarget();
+            add(passing, predicted, simulated, tolerance + max(abs(sooner - predicted), abs(later - predicted)));
+        } else {
+            add(normal, predicted, simulated, tolerance);
+        }
+        if (normal.errors + passing.errors + unsupported.errors > errors && normal.errors + passing.errors + unsupported.errors <= 3) {
+            printf("  v=%g a=%g d=%g maxStoppingDecel=%g position=%g velocity=%g target=%g wrongWay=%d tooFast=%d: predicted %g simulated %g\n",
+                velLimit, accelLimit, decelLimit, maxStoppingDecel, position, velocity, target, preventGoingWrongWay, preventGoingTooFast, predicted, simulated);
+        }
+
+        add(stopping, l.getTimeToStop(), simulateStop(l, 2 * l.getTimeToStop() + 1), 2 * dt);
+    }
+    printf("getTimeToTarget, %ld states: errors %ld, max difference %.4f s (%.2f%%)\n", normal.states, normal.errors, normal.maxError, 100 * normal.maxRelativeError);
+    printf("getTimeToTarget passing the target and coming back, %ld states: errors %ld, max difference %.4f s (%.2f%%)\n", passing.states, passing.errors, passing.maxError, 100 * passing.maxRelativeError);
+    printf("getTimeToTarget passing the target with preventGoingWrongWay (not supported), %ld states: arrived before the time given %ld, arrived up to %.4f s later\n", unsupported.states, unsupported.errors, unsupported.maxError);
+    printf("getTimeToStop, %ld states: errors %ld, max difference %.4f s\n", stopping.states, stopping.errors, stopping.maxError);
+    long errors = normal.errors + passing.errors + unsupported.errors + stopping.errors;
+    printf("errors: %ld\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+/**
+ * WaypointPath, checks that Derivs_Limiter_Waypoints passes through waypoints without stopping, and stops where it should
+ * https://github.com/joshua-8/Derivs_Limiter
+ *
+ * Each path starts from rest at 0 with random limits (velLimit 1 to 300, accelLimit and decelLimit 1 to 1000) and 2 to 8 random waypoints
+ * (1 to 50 apart, turning around about a third of the time), and is stepped with a random time interval (0.5 to 5 ms). Checks that
+ * - a waypoint where the direction reverses, and the last one, are stopped at (velocity 0 exactly at the waypoint, going past it by no more than the
+ *   step past its target the calculation can take before stopping)
+ * - every other waypoint is passed while still moving towards it, not stopped at or before
+ * - the speed passing a waypoint isn't over the junction speed the queue planned for it (give or take a step of acceleration)
+ * - velocity never goes over velLimit and never turns around between stops
+ * - the path takes no longer than moving to each waypoint with setTarget() and stopping there, give or take 40 time intervals per stop (the last approach
+ *   to a target takes a number of intervals that depends on where the steps fall, see getTimeToTarget())
+ * Uses Derivs_Limiter_T<double>, with float a very low decelLimit can leave the last creep towards a target smaller than the rounding of position.
+ * Usage: WaypointPath [number of paths]
+ * Prints a summary and returns 1 if anything was wrong.
+ */
+#include <Derivs_Limiter.h>
+#include <Derivs_Limiter_Waypoints.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef Derivs_Limiter_T<double> Limiter;
+
+const size_t MAX_WAYPOINTS = 8;
+
+static unsigned long seed = 1;
+static double randomDouble(double low, double high)
+{
+    seed = seed * 1103515245 + 12345;
+    return low + (high - low) * ((seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+struct Result {
+    long unfinished;
+    long missedStop; // not stopped at a waypoint where it turns around or the last one
+    long stoppedEarly; // stopped at or before a waypoint it should pass through
+    long overJunction; // passed a waypoint faster than its junction speed
+    long overVelocity;
+    long wrongWay;
+    long slower; // took longer than stopping at every waypoint
+    long failed; // paths with anything wrong
+    long passed; // waypoints passed through, for the summary
+    double timeSaved; // total over all paths, seconds
+    double maxJunctionRatio; // speed passing a waypoint / its junction speed
+};
+
+/**
+ * moves to each waypoint with setTarget() and stops there, returns the total time or INFINITY if it didn't finish within maxTime
+ */
+static double stopAtEach(Limiter l, const double* path, size_t n, double dt, double maxTime)
+{
+    double t = 0;
+    for (size_t i = 0; i < n; i++) {
+        l.setTarget(path[i]);
+        while (!(l.isPosAtTarget() && l.getVelocity() == 0)) {
+            if (t > maxTime) {
+                return INFINITY;
+            }
+            l.step(dt);
+            t += dt;
+        }
+    }
+    return t;
+}
+
+/**
+ * one path, returns true if it was all right
+ */
+static bool runPath(Result& r)
+{
+    double velLimit = randomDouble(1, 300);
+    double accelLimit = randomDouble(1, 1000);
+    double decelLimit = randomDouble(1, 1000);
+    double dt = randomDouble(0.0005, 0.005);
+    size_t n = 2 + (size_t)randomDouble(0, MAX_WAYPOINTS - 2 + 0.999);
+    double path[MAX_WAYPOINTS];
+    bool stops[MAX_WAYPOINTS]; // where it should stop
+    double direction = (randomDouble(0, 1) < 0.5) ? 1 : -1;
+    double total = 0; // distance
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0 && randomDouble(0, 1) < 0.33) {
+            direction = -direction;
+        }
+        double step = randomDouble(1, 50);
+        path[i] = (i == 0 ? 0 : path[i - 1]) + direction * step;
+        total += step;
+    }
+    for (size_t i = 0; i < n; i++) {
+        stops[i] = (i == n - 1) || ((path[i + 1] - path[i]) * (path[i] - (i == 0 ? 0 : path[i - 1])) < 0);
+    }
+    // generous bound: stopping at every waypoint, each a trapezoid or triangle
+    double maxTime = 3 * (total / velLimit + n * (velLimit / accelLimit + velLimit / decelLimit + 2 * sqrt(100 / accelLimit) + 2 * sqrt(100 / decelLimit))) + 1;
+
+    Limiter l = Limiter(velLimit, accelLimit, decelLimit, 0, 0);
+    Derivs_Limiter_Waypoints<MAX_WAYPOINTS, Limiter> waypoints(&l);
+    for (size_t i = 0; i < n; i++) {
+        waypoints.add(path[i]);
+    }
+
+    bool missedStop = false, stoppedEarly = false, overJunction = false, overVelocity = false, wrongWay = false;
+    size_t next = 0; // waypoint being moved to
+    bool moving = false; // has moved towards it since the last stop
+    double t = 0;
+    while (next < n && t < maxTime) {
+        double from = (next == 0) ? 0 : path[next - 1];
+        double dir = (path[next] > from) ? 1 : -1;
+        waypoints.update();
+        double junction = waypoints.getJunctionSpeed();
+        l.step(dt);
+        t += dt;
+        double velocity = l.getVelocity();
+        double position = l.getPosition();
+        if (abs(velocity) > velLimit * (1 + 1e-5)) {
+            overVelocity = true;
+        }
+        if (dir * velocity > 0) {
+            moving = true;
+        } else if (dir * velocity < 0) {
+            wrongWay = true;
+        }
+        // the calculation can stop up to a step past its target and then jump to it
+        double stepDistance = velLimit * dt * 1.001 + 1e-5 * (abs(path[next]) + 1);
+        if (stops[next]) {
+            if (dir * (position - path[next]) > stepDistance) {
+                missedStop = true;
+            }
+            if (velocity == 0 && moving) {
+                if (position == path[next]) {
+                    next++;
+                    moving = false;
+                } else if (abs(position - path[next]) > stepDistance) {
+                    stoppedEarly = true;
+                    moving = false;
+                }
+            }
+        } else {
+            if (velocity == 0 && moving) {
+                stoppedEarly = true;
+                moving = false;
+            }
+            while (next < n && !stops[next] && dir * (position - path[next]) >= 0) { // a fast step can pass more than one
+                if (!(dir * velocity > 0)) {
+                    stoppedEarly = true;
+                }
+                double speed = abs(velocity);
+                if (junction > 0) {
+                    r.maxJunctionRatio = max(r.maxJunctionRatio, speed / junction);
+                }
+                if (speed > junction * (1 + 1e-4) + max(accelLimit, decelLimit) * dt) {
+                    overJunction = true;
+                }
+                r.passed++;
+                next++;
+            }
+        }
+    }
+    bool finished = (next == n) && l.isPosAtTarget() && l.getPosition() == path[n - 1] && l.getVelocity() == 0;
+    bool ok = true;
+    if (!finished) {
+        r.unfinished++;
+        ok = false;
+    } else {
+        double stopping = stopAtEach(Limiter(velLimit, accelLimit, decelLimit, 0, 0), path, n, dt, maxTime);
+        size_t stopCount = 0;
+        for (size_t i = 0; i < n; i++) {
+            stopCount += stops[i];
+        }
+        if (t > stopping + 40 * dt * stopCount) {
+            r.slower++;
+            ok = false;
+        } else {
+            r.timeSaved += stopping - t;
+        }
+    }
+    long* counts[] = { &r.missedStop, &r.stoppedEarly, &r.overJunction, &r.overVelocity, &r.wrongWay };
+    bool fails[] = { missedStop, stoppedEarly, overJunction, overVelocity, wrongWay };
+    for (int i = 0; i < 5; i++) {
+        if (fails[i]) {
+            (*counts[i])++;
+            ok = false;
+        }
+    }
+    if (!ok && ++r.failed <= 3) {
+        printf("  v=%g a=%g d=%g dt=%g finished=%d missedStop=%d stoppedEarly=%d overJunction=%d overVelocity=%d wrongWay=%d path:",
+            velLimit, accelLimit, decelLimit, dt, finished, missedStop, stoppedEarly, overJunction, overVelocity, wrongWay);
+        for (size_t i = 0; i < n; i++) {
+            printf(" %g%s", path[i], stops[i] ? "(stop)" : "");
+        }
+        printf("\n");
+    }
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    long paths = 2000;
+    if (argc > 1) {
+        paths = atol(argv[1]);
+    }
+    Result r = Result();
+    int errors = 0;
+    for (long i = 0; i < paths; i++) {
+        if (!runPath(r)) {
+            errors++;
+        }
+    }
+    printf("%ld paths, %ld waypoints passed through: unfinished %ld, missed stops %ld, stopped early %ld, over junction speed %ld (max %.4f), over velLimit %ld, wrong way %ld, slower than stopping %ld\n",
+        paths, r.passed, r.unfinished, r.missedStop, r.stoppedEarly, r.overJunction, r.maxJunctionRatio, r.overVelocity, r.wrongWay, r.slower);
+    printf("time saved compared to stopping at every waypoint: %.3f s per path\n", paths ? r.timeSaved / paths : 0);
+    printf("errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
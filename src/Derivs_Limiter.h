@@ -1,37 +1,907 @@
 #ifndef _DERIVS_LIMITER_H_
 #define _DERIVS_LIMITER_H_
+#if defined(ARDUINO) || defined(ESP_PLATFORM)
 #include <Arduino.h>
+#else
+#include "Derivs_Limiter_Shim.h"
+#endif
+
+template <typename Scalar>
+class Derivs_Limiter_Profile_T; // in Derivs_Limiter_Profile.h
+template <typename Scalar>
+class Derivs_Limiter_Mailbox_T; // in Derivs_Limiter_Mailbox.h
+template <typename Scalar>
+struct Derivs_Limiter_Command_T; // in Derivs_Limiter_Mailbox.h
+
 /**
- * @brief  This library can be used to limit the first and second derivative of a variable as it approaches a target value.
- * https://github.com/joshua-8/Derivs_Limiter
+ * @brief  the math of one calculation step, shared by Derivs_Limiter, Derivs_Limiter_Bank and Derivs_Limiter_Fixed_Rate so that they give the same results
+ * @note   parameters are named after the Derivs_Limiter fields they take, see Derivs_Limiter for what each one means. Scalar is float or double.
+ */
+struct Derivs_Limiter_Kernel {
+    /**
+     * @brief  which part of the calculation ran, returned by posMode() and velMode()
+     */
+    enum Regime {
+        AT_TARGET, // stopped at the target, nothing was calculated
+        SNAP_TO_TARGET, // close enough and slow enough, position was set to target
+        DECEL_TO_TARGET, // slowing down to stop at the target
+        WRONG_WAY_DECEL, // slowing down because velocity is away from the target
+        ACCELERATE, // speeding up towards the target
+        TOO_FAST_DECEL, // slowing down to velLimit
+        COAST, // moving at velLimit
+        VELOCITY_MODE // velocity mode, approaching velocityTarget
+    };
+    static const int regimeCount = VELOCITY_MODE + 1; // number of Regimes
+
+    /**
+     * @brief  keep position and target within the position limits, velocity is zeroed if position was outside them
+     * @retval None
+     */
+    template <typename Scalar>
+    static void constrainToPosLimits(Scalar& position, Scalar& velocity, Scalar& target, Scalar posLimitLow, Scalar posLimitHigh)
+    {
+        if (position > posLimitHigh) {
+            position = posLimitHigh;
+            velocity = 0;
+        } else if (position < posLimitLow) {
+            position = posLimitLow;
+            velocity = 0;
+        }
+        target = constrain(target, posLimitLow, posLimitHigh);
+    }
+
+    /**
+     * @brief  the products of the limits and the time interval that posMode() and velMode() use
+     * @note   Derivs_Limiter works them out for each step, Derivs_Limiter_Fixed_Rate keeps Cached_Products and only works them out again when a limit or the time step changes.
+     */
+    template <typename Scalar>
+    struct Products {
+        Scalar time;
+        Scalar accelLimit;
+        Scalar decelLimit;
+        Scalar accelStep; // accelLimit * time
+        Scalar decelStep; // decelLimit * time
+        Scalar twoDecelLimit; // 2 * decelLimit
+        Scalar maxDecel; // decelLimit * maxStoppingDecel
+        Scalar maxDecelStep; // decelLimit * maxStoppingDecel * time
+
+        Products() { }
+        Products(Scalar _accelLimit, Scalar _decelLimit, Scalar maxStoppingDecel, Scalar _time)
+        {
+            set(_accelLimit, _decelLimit, maxStoppingDecel, _time);
+        }
+        void set(Scalar _accelLimit, Scalar _decelLimit, Scalar maxStoppingDecel, Scalar _time)
+        {
+            time = _time;
+            accelLimit = _accelLimit;
+            decelLimit = _decelLimit;
+            accelStep = accelLimit * time;
+            decelStep = decelLimit * time;
+            twoDecelLimit = 2 * decelLimit;
+            maxDecel = decelLimit * maxStoppingDecel;
+            maxDecelStep = maxDecel * time;
+        }
+        // a change in velocity divided by time, only used for accel
+        Scalar perTime(Scalar x) const
+        {
+            return x / time;
+        }
+    };
+
+    /**
+     * @brief  Products that also keep 1 / time, so accel is multiplied instead of divided (it can differ from Products in the last bit, position and velocity don't)
+     */
+    template <typename Scalar>
+    struct Cached_Products : public Products<Scalar> {
+        Scalar invTime;
+
+        void set(Scalar _accelLimit, Scalar _decelLimit, Scalar maxStoppingDecel, Scalar _time)
+        {
+            Products<Scalar>::set(_accelLimit, _decelLimit, maxStoppingDecel, _time);
+            invTime = 1 / _time;
+        }
+        Scalar perTime(Scalar x) const
+        {
+            return x * invTime;
+        }
+    };
+
+    /**
+     * @brief  one step of position mode, moves position towards target
+     * @param  time: (Scalar) seconds since the last step, must be greater than 0
+     * @retval (Regime) AT_TARGET means nothing changed (accel is set to 0)
+     */
+    template <typename Scalar>
+    static Regime posMode(Scalar& position, Scalar& velocity, Scalar& accel, Scalar target, Scalar velLimit, Scalar accelLimit,
+        Scalar decelLimit, Scalar maxStoppingDecel, bool preventGoingWrongWay, Scalar time)
+    {
+        return posMode(position, velocity, accel, target, velLimit, preventGoingWrongWay, Products<Scalar>(accelLimit, decelLimit, maxStoppingDecel, time));
+    }
+
+    /**
+     * @brief  posMode() with the products of the limits and the time interval given
+     * @param  p: Products or Cached_Products (or anything with the same members)
+     */
+    template <typename Scalar, typename P>
+    static Regime posMode(Scalar& position, Scalar& velocity, Scalar& accel, Scalar target, Scalar velLimit, bool preventGoingWrongWay, const P& p)
+    {
+        const Scalar time = p.time;
+        if (preventGoingWrongWay && velocity != 0 && target != position && ((velocity > 0) != (target - position > 0))) { // going the wrong way
+            velocity = 0;
+        }
+
+        if (velocity == 0 && position == target) { // if stopped at the target, no calculations are needed
+            accel = 0;
+            return AT_TARGET;
+        }
+
+        if (velocity != 0 && target != position && (velocity > 0) == (target - position > 0)
+            && (abs(position - target) - abs(velocity * time) <= sq(velocity) / p.twoDecelLimit)) {
+            // predicted to be too close next time, decel now.
+            if (abs(position - target) <= abs(velocity * time) && (abs(velocity) <= p.maxDecelStep)) { // close enough and slow enough, just stop
+                accel = 0;
+                velocity = 0;
+                position = target;
+                return SNAP_TO_TARGET;
+            } else { // decel
+                accel = -sq(velocity) / 2 / (target - position);
+                accel = constrain(accel, -p.maxDecel, p.maxDecel);
+                velocity += accel * time;
+                position += velocity * time;
+                return DECEL_TO_TARGET;
+            }
+        } else if (velocity != 0 && target != position && (velocity > 0) != (target - position > 0)) { // if going wrong way, decel
+            bool targetAbove = (target - position > 0);
+            accel = targetAbove ? p.decelLimit : -p.decelLimit;
+            velocity += targetAbove ? p.decelStep : -p.decelStep;
+            if (velocity != 0 && (velocity > 0) == targetAbove) { // switched direction, stop at zero velocity, in case accel is lower
+                velocity = 0;
+                accel = 0;
+            } else {
+                position += velocity * time;
+            }
+            return WRONG_WAY_DECEL;
+        } else if (abs(velocity) < velLimit) { // too slow, speed up
+            Scalar tempVelocity = velocity;
+            velocity += (position > target) ? -p.accelStep : p.accelStep;
+            velocity = constrain(velocity, -velLimit, velLimit);
+            Scalar maxSpeedThatCanBeStopped = sqrt(p.twoDecelLimit * abs(position - target)); // v^2 = u^2 + 2as
+            velocity = constrain(velocity, -maxSpeedThatCanBeStopped, maxSpeedThatCanBeStopped);
+            accel = p.perTime(velocity - tempVelocity);
+            position += velocity * time;
+            if (abs(position - target) <= abs(velocity * time) && (abs(velocity) <= p.maxDecelStep)) { // close enough and slow enough, just stop
+                accel = 0;
+                velocity = 0;
+                position = target;
+                return SNAP_TO_TARGET;
+            }
+            return ACCELERATE;
+        } else if (abs(velocity) > velLimit) { // too fast, slow down
+            Scalar tempVelocity = velocity;
+            if (velocity > 0) {
+                velocity = max(velocity - p.decelStep, velLimit);
+            } else {
+                velocity = min(velocity + p.decelStep, -velLimit);
+            }
+            accel = p.perTime(velocity - tempVelocity);
+            position += velocity * time;
+            return TOO_FAST_DECEL;
+        } else { // coast, no accel
+            accel = 0;
+            position += velocity * time;
+            return COAST;
+        }
+    }
+
+    /**
+     * @brief  one step of velocity mode, moves velocity towards velocityTarget (which gets constrained to velLimit)
+     * @param  time: (Scalar) seconds since the last step, must be greater than 0
+     * @retval (Regime) VELOCITY_MODE
+     */
+    template <typename Scalar>
+    static Regime velMode(Scalar& position, Scalar& velocity, Scalar& accel, Scalar& velocityTarget, Scalar velLimit, Scalar accelLimit,
+        Scalar decelLimit, bool preventGoingWrongWay, Scalar time)
+    {
+        return velMode(position, velocity, accel, velocityTarget, velLimit, preventGoingWrongWay, Products<Scalar>(accelLimit, decelLimit, 1, time));
+    }
+
+    /**
+     * @brief  velMode() with the products of the limits and the time interval given
+     * @param  p: Products or Cached_Products (or anything with the same members)
+     */
+    template <typename Scalar, typename P>
+    static Regime velMode(Scalar& position, Scalar& velocity, Scalar& accel, Scalar& velocityTarget, Scalar velLimit, bool preventGoingWrongWay, const P& p)
+    {
+        Scalar tempVelocity = velocity;
+        velocityTarget = constrain(velocityTarget, -velLimit, velLimit);
+        if (preventGoingWrongWay && velocity != 0 && velocityTarget != 0 && (velocity > 0) != (velocityTarget > 0)) {
+            velocity = 0;
+        }
+        if (velocity != velocityTarget) {
+            if (velocity == 0) {
+                velocity += constrain(velocityTarget - velocity, -p.accelStep, p.accelStep);
+            } else if (velocity > 0) {
+                velocity += constrain(velocityTarget - velocity, -p.decelStep, p.accelStep);
+                if (velocity < 0) { // prevent decel from crossing zero and causing accel
+                    velocity = 0;
+                }
+            } else { // velocity < 0
+                velocity += constrain(velocityTarget - velocity, -p.accelStep, p.decelStep);
+                if (velocity > 0) { // prevent decel from crossing zero and causing accel
+                    velocity = 0;
+                }
+            }
+        }
+        accel = p.perTime(velocity - tempVelocity);
+        position += velocity * p.time;
+        return VELOCITY_MODE;
+    }
+
+    /**
+     * @brief  acceleration for one step that brings speed closer to a speed gap ahead, as fast as possible without going past it
+     * @note   after the step, ramping acceleration back to 0 at jerkLimit covers the rest of the gap: accel * time + accel^2 / 2 / jerkLimit = gap
+     * @param  gap: (Scalar) >= 0
+     * @retval (Scalar) >= 0
+     */
+    template <typename Scalar>
+    static Scalar jerkApproachAccel(Scalar gap, Scalar jerkLimit, Scalar time)
+    {
+        return 2 * gap / (time + sqrt(sq(time) + 2 * gap / jerkLimit)); // the positive root, written so it doesn't lose precision when gap is small
+    }
+
+    /**
+     * @brief  how far position goes forward before it stops, braking with jerk up to jerkLimit and deceleration up to decelLimit
+     * @param  speed: (Scalar) can be negative (moving backward)
+     * @param  acc: (Scalar) current acceleration, positive is speeding up forward
+     * @retval (Scalar) distance to where velocity reaches 0, 0 if it never moves forward
+     */
+    template <typename Scalar>
+    static Scalar jerkStoppingDistance(Scalar speed, Scalar acc, Scalar decelLimit, Scalar jerkLimit)
+    {
+        if (acc <= 0 && speed <= sq(acc) / 2 / jerkLimit) { // already braking hard enough, velocity reaches 0 while accel ramps back to 0
+            if (speed <= 0) {
+                return 0;
+            }
+            Scalar t = (-acc - sqrt(sq(acc) - 2 * jerkLimit * speed)) / jerkLimit;
+            return speed * t + acc * sq(t) / 2 + jerkLimit * t * t * t / 6;
+        }
+        Scalar peakSq = jerkLimit * speed + sq(acc) / 2;
+        if (!(peakSq > 0)) { // moving backward, and braking right away keeps it from ever moving forward
+            return 0;
+        }
+        // ramp accel to -peak, hold, ramp back up to 0 as velocity reaches 0
+        Scalar peak = sqrt(peakSq);
+        bool hold = peak > decelLimit;
+        if (hold) {
+            peak = decelLimit;
+        }
+        Scalar rampJerk = (acc > -peak) ? -jerkLimit : jerkLimit; // accel can already be past -decelLimit (after braking at decelLimit * maxStoppingDecel)
+        Scalar rampTime = abs(acc + peak) / jerkLimit;
+        Scalar dist = speed * rampTime + acc * sq(rampTime) / 2 + rampJerk * rampTime * rampTime * rampTime / 6;
+        if (hold) {
+            Scalar rampSpeed = speed + acc * rampTime + rampJerk * sq(rampTime) / 2;
+            Scalar holdTime = max((rampSpeed - sq(peak) / 2 / jerkLimit) / peak, (Scalar)0);
+            dist += rampSpeed * holdTime - peak * sq(holdTime) / 2;
+        }
+        return dist + peak * peak * peak / 6 / sq(jerkLimit);
+    }
+
+    /**
+     * @brief  distance that would be left over if position stopped as soon as it can after one step with an acceleration, used by posModeJerk()
+     * @retval (Scalar) negative if it would go past the target
+     */
+    template <typename Scalar>
+    static Scalar jerkStoppingSlack(Scalar dist, Scalar speed, Scalar nextAcc, Scalar decelLimit, Scalar jerkLimit, Scalar time)
+    {
+        Scalar nextSpeed = speed + nextAcc * time;
+        return dist - nextSpeed * time - jerkStoppingDistance(nextSpeed, nextAcc, decelLimit, jerkLimit);
+    }
+
+    /**
+     * @brief  the highest acceleration from high down to low for which jerkStoppingSlack() isn't negative, found with two steps of regula falsi
+     * @param  highSlack: (Scalar) jerkStoppingSlack() for high, negative
+     * @param  lowSlack: (Scalar) jerkStoppingSlack() for low, not negative
+     * @retval (Scalar) low if no better acceleration was found
+     */
+    template <typename Scalar>
+    static Scalar jerkBrakingAccel(Scalar dist, Scalar speed, Scalar high, Scalar highSlack, Scalar low, Scalar lowSlack, Scalar decelLimit, Scalar jerkLimit, Scalar time)
+    {
+        for (int i = 0; i < 2; i++) {
+            Scalar mid = constrain(high + (low - high) * highSlack / (highSlack - lowSlack), min(low, high), max(low, high));
+            Scalar midSlack = jerkStoppingSlack(dist, speed, mid, decelLimit, jerkLimit, time);
+            if (midSlack >= 0) {
+                low = mid;
+                lowSlack = midSlack;
+            } else {
+                high = mid;
+                highSlack = midSlack;
+            }
+        }
+        return low;
+    }
+
+    /**
+     * @brief  one step of position mode with acceleration changing no faster than jerkLimit, accel is used as part of the state
+     * @note   Speed approaches velLimit without going over it. Each step checks that position could still stop at the target after it, and if not brakes, by only as much as is needed.
+     *         The step that arrives leaves accel within jerkLimit of 0, so the next one (AT_TARGET) sets it to 0 without going over jerkLimit.
+     * @param  jerkLimit: (Scalar) greater than 0 and not INFINITY
+     * @param  time: (Scalar) seconds since the last step, must be greater than 0
+     * @retval (Regime) AT_TARGET means nothing changed
+     */
+    template <typename Scalar>
+    static Regime posModeJerk(Scalar& position, Scalar& velocity, Scalar& accel, Scalar target, Scalar velLimit, Scalar accelLimit,
+        Scalar decelLimit, Scalar maxStoppingDecel, Scalar jerkLimit, bool preventGoingWrongWay, Scalar time)
+    {
+        if (preventGoingWrongWay && velocity != 0 && target != position && ((velocity > 0) != (target - position > 0))) { // going the wrong way
+            velocity = 0;
+            accel = 0;
+        }
+
+        Scalar jerkTime = jerkLimit * time;
+        if (velocity == 0 && position == target) { // if stopped at the target, no calculations are needed
+            if (accel == 0) {
+                return AT_TARGET;
+            }
+            accel = constrain((Scalar)0, accel - jerkTime, accel + jerkTime); // arrived with a little accel left (less than jerkLimit allows in a step, but this step can be shorter)
+            return SNAP_TO_TARGET;
+        }
+
+        // work in the direction of the target (or of velocity, if at the target but moving)
+        Scalar dir = (target - position > 0 || (target == position && velocity > 0)) ? 1 : -1;
+        Scalar dist = dir * (target - position);
+        Scalar speed = dir * velocity;
+        Scalar acc = dir * accel;
+
+        Regime regime;
+        Scalar goAcc; // acceleration if there was no need to stop for the target
+        if (speed < 0) { // going wrong way, decel
+            goAcc = min(decelLimit, jerkApproachAccel(velLimit - speed, jerkLimit, time));
+            regime = WRONG_WAY_DECEL;
+        } else if (speed <= velLimit) { // too slow, speed up (or coast at velLimit)
+            goAcc = min(accelLimit, jerkApproachAccel(velLimit - speed, jerkLimit, time));
+            regime = (speed == velLimit && acc == 0) ? COAST : ACCELERATE;
+        } else { // too fast, slow down
+            goAcc = -min(decelLimit, jerkApproachAccel(speed - velLimit, jerkLimit, time));
+            regime = TOO_FAST_DECEL;
+        }
+        Scalar nextAcc = constrain(goAcc, acc - jerkTime, acc + jerkTime);
+
+        // if after this step it would be too late to stop at the target, brake now instead, as little as needed
+        Scalar goSlack = jerkStoppingSlack(dist, speed, nextAcc, decelLimit, jerkLimit, time);
+        if (goSlack < 0) {
+            regime = DECEL_TO_TARGET;
+            Scalar brakeAcc = constrain(-decelLimit, acc - jerkTime, acc + jerkTime);
+            Scalar brakeSlack = jerkStoppingSlack(dist, speed, brakeAcc, decelLimit, jerkLimit, time);
+            if (brakeSlack >= 0) {
+                nextAcc = jerkBrakingAccel(dist, speed, nextAcc, goSlack, brakeAcc, brakeSlack, decelLimit, jerkLimit, time);
+            } else { // can't stop in time at decelLimit, brake up to decelLimit * maxStoppingDecel
+                Scalar hardLimit = decelLimit * maxStoppingDecel;
+                Scalar hardAcc = constrain(-hardLimit, acc - jerkTime, acc + jerkTime);
+                Scalar softSlack = jerkStoppingSlack(dist, speed, brakeAcc, hardLimit, jerkLimit, time);
+                Scalar hardSlack = jerkStoppingSlack(dist, speed, hardAcc, hardLimit, jerkLimit, time);
+                if (softSlack >= 0) {
+                    nextAcc = brakeAcc;
+                } else if (hardSlack >= 0) {
+                    nextAcc = jerkBrakingAccel(dist, speed, brakeAcc, softSlack, hardAcc, hardSlack, hardLimit, jerkLimit, time);
+                } else { // will go past the target and come back
+                    nextAcc = hardAcc;
+                }
+            }
+        }
+
+        Scalar newSpeed = speed + nextAcc * time;
+        if (speed <= velLimit && newSpeed > velLimit) { // only rounding can take it over
+            newSpeed = velLimit;
+        }
+        velocity = dir * newSpeed;
+        accel = dir * nextAcc;
+        Scalar lastPosition = position;
+        position += velocity * time;
+
+        // arriving: close enough and slow enough, and accel is close enough to 0 to be set to 0 within jerkLimit.
+        // At the end of the move velocity * time can be too small to change position, then it would never arrive, so it also stops if position didn't change while slowing down for the target
+        // (or when starting from a stop within the precision of position)
+        if (abs(accel) <= jerkTime
+            && ((abs(target - position) <= jerkTime * sq(time) && abs(velocity) <= jerkTime * time)
+                || (position == lastPosition && (regime == DECEL_TO_TARGET || position + (target - position) / 64 == position)))) {
+            velocity = 0;
+            position = target;
+            return SNAP_TO_TARGET;
+        }
+        return regime;
+    }
+
+    /**
+     * @brief  one step of velocity mode with acceleration changing no faster than jerkLimit, accel is used as part of the state
+     * @note   velocity approaches velocityTarget without going past it (unless velocityTarget changed while accel was too high to stop in time)
+     * @param  jerkLimit: (Scalar) greater than 0 and not INFINITY
+     * @param  time: (Scalar) seconds since the last step, must be greater than 0
+     * @retval (Regime) VELOCITY_MODE
+     */
+    template <typename Scalar>
+    static Regime velModeJerk(Scalar& position, Scalar& velocity, Scalar& accel, Scalar& velocityTarget, Scalar velLimit, Scalar accelLimit,
+        Scalar decelLimit, Scalar jerkLimit, bool preventGoingWrongWay, Scalar time)
+    {
+        velocityTarget = constrain(velocityTarget, -velLimit, velLimit);
+        if (preventGoingWrongWay && velocity != 0 && velocityTarget != 0 && (velocity > 0) != (velocityTarget > 0)) {
+            velocity = 0;
+            accel = 0;
+        }
+        Scalar diff = velocityTarget - velocity;
+        Scalar limit = (velocity == 0 || (velocity > 0) == (diff > 0)) ? accelLimit : decelLimit; // speeding up or slowing down
+        Scalar desiredAcc = min(limit, jerkApproachAccel(abs(diff), jerkLimit, time));
+        if (diff < 0) {
+            desiredAcc = -desiredAcc;
+        }
+        Scalar jerkTime = jerkLimit * time;
+        Scalar newAccel = constrain(desiredAcc, accel - jerkTime, accel + jerkTime);
+        Scalar newVelocity = velocity + newAccel * time;
+        if (abs(newAccel) <= jerkTime && ((diff >= 0 && newVelocity >= velocityTarget) || (diff <= 0 && newVelocity <= velocityTarget))) {
+            newVelocity = velocityTarget; // reached velocityTarget, and accel is close enough to 0 to set it to 0 next step within jerkLimit
+        } else if (newVelocity == velocity && velocity + diff / 64 == velocity) { // accel * time is too small to change velocity, and velocityTarget is within the precision of velocity
+            newVelocity = velocityTarget;
+        }
+        if (abs(velocity) <= velLimit) { // only rounding, or a velocityTarget changed while accel was high, can take it over
+            newVelocity = constrain(newVelocity, -velLimit, velLimit);
+        }
+        accel = newAccel;
+        velocity = newVelocity;
+        position += velocity * time;
+        return VELOCITY_MODE;
+    }
+};
+
+/**
+ * @brief  default clock policy for Derivs_Limiter_T, time comes from micros()
+ * @note   a clock policy is any type with a static now() function that returns the time as an unsigned long. It counts microseconds,
+ *         unless the type also has a static const unsigned long ticksPerSecond (see Derivs_Limiter_Clock_Rate).
  */
-class Derivs_Limiter {
+struct Derivs_Limiter_Micros_Clock {
+    static const unsigned long ticksPerSecond = 1000000;
+    static unsigned long now()
+    {
+        return micros();
+    }
+};
+
+/**
+ * @brief  how many times a second a clock policy's now() counts up: Clock::ticksPerSecond if it has one, otherwise 1000000 (microseconds, like micros())
+ * @note   everything that reads a Clock converts its time to seconds with this, use Derivs_Limiter_Clock_Rate<Clock>::ticksPerSecond
+ */
+template <typename Clock>
+struct Derivs_Limiter_Clock_Rate {
 protected:
-    float position;
-    float velocity;
-    float accel;
-    unsigned long lastTime;
-    float target;
-    float velLimit;
-    float accelLimit;
-    float decelLimit;
-    float time;
+    template <typename C, unsigned long = C::ticksPerSecond>
+    static char check(int);
+    template <typename C>
+    static long check(...);
+    template <typename C, bool Has>
+    struct Value {
+        static const unsigned long ticksPerSecond = 1000000;
+    };
+    template <typename C>
+    struct Value<C, true> {
+        static const unsigned long ticksPerSecond = C::ticksPerSecond;
+    };
+
+public:
+    static const unsigned long ticksPerSecond = Value<Clock, sizeof(check<Clock>(0)) == 1>::ticksPerSecond;
+};
+
+/**
+ * @brief  what a Derivs_Limiter has been doing, counted when the Stats feature is compiled in (see Derivs_Limiter_Features)
+ * @note   get one with getStats() or takeStats(). Counts are unsigned long and wrap around after 4294967295.
+ */
+template <typename Scalar = float>
+struct Derivs_Limiter_Stats_T {
+    unsigned long regimes[Derivs_Limiter_Kernel::regimeCount]; // calculations (or sub-steps, see setMaxSubStep()) in each part of the calculation, use a Derivs_Limiter_Kernel::Regime as the index
+    unsigned long profileSteps; // calculations (or sub-steps) that followed a Derivs_Limiter_Profile
+    unsigned long steps; // calculations with a time interval greater than 0
+    unsigned long skippedSteps; // calculations with a time interval of 0 (like the first calc()), nothing was calculated
+    unsigned long overruns; // calculations with a time interval longer than the overrun threshold
+    Scalar minDt; // shortest time interval (seconds), INFINITY if there were no steps
+    Scalar maxDt; // longest time interval (seconds)
+    Scalar totalDt; // sum of the time intervals (seconds)
+    unsigned long calcMicros; // time spent calculating, measured with the Derivs_Limiter's clock so it's only as precise as the clock (micros() counts by 4 on an Arduino Uno)
+
+    Derivs_Limiter_Stats_T()
+    {
+        reset();
+    }
+
+    /**
+     * @brief  set everything back to 0
+     * @retval None
+     */
+    void reset()
+    {
+        for (int i = 0; i < Derivs_Limiter_Kernel::regimeCount; i++) {
+            regimes[i] = 0;
+        }
+        profileSteps = 0;
+        steps = 0;
+        skippedSteps = 0;
+        overruns = 0;
+        minDt = INFINITY;
+        maxDt = 0;
+        totalDt = 0;
+        calcMicros = 0;
+    }
+
+    /**
+     * @brief  average time interval
+     * @retval (float) seconds, 0 if there were no steps
+     */
+    Scalar getMeanDt() const
+    {
+        if (steps == 0)
+            return 0;
+        return totalDt / steps;
+    }
+};
+
+typedef Derivs_Limiter_Stats_T<float> Derivs_Limiter_Stats;
+
+/**
+ * @brief  feature policy for Derivs_Limiter_T, which optional features are compiled in
+ * @note   A feature that is turned off costs no instructions in the calculation and no bytes in the object. Its setters do nothing and its getters return the value that means "off"
+ *         (NULL pointers, false, -INFINITY and INFINITY position limits). Derivs_Limiter_All_Features is the default and keeps the first four settable at runtime,
+ *         the features after them are off unless asked for, like with Derivs_Limiter_Stats_Features, Derivs_Limiter_Profile_Features, Derivs_Limiter_Jerk_Features,
+ *         Derivs_Limiter_Mailbox_Features or Derivs_Limiter_Sub_Step_Features.
+ * @tparam Pointers: setPositionPointer() and setVelocityPointer()
+ * @tparam PreventGoingWrongWay: setPreventGoingWrongWay()
+ * @tparam PreventGoingTooFast: setPreventGoingTooFast()
+ * @tparam PosLimits: setPosLimits()
+ * @tparam Stats: default=false, count what the calculation does, see getStats() and Derivs_Limiter_Stats (off in Derivs_Limiter_All_Features, it reads the clock twice per calculation)
+ * @tparam Profile: default=false, setProfile(), needs Derivs_Limiter_Profile.h to be included (off in Derivs_Limiter_All_Features, it adds a pointer and a check to every calculation)
+ * @tparam Jerk: default=false, setJerkLimit() (off in Derivs_Limiter_All_Features, it adds a value and a check to every calculation)
+ * @tparam Mailbox: default=false, setMailbox(), needs Derivs_Limiter_Mailbox.h to be included (off in Derivs_Limiter_All_Features, it adds a pointer and a check to every calculation)
+ * @tparam SubSteps: default=false, setMaxSubStep() (off in Derivs_Limiter_All_Features, it adds two values and a check to every calculation)
+ */
+template <bool Pointers, bool PreventGoingWrongWay, bool PreventGoingTooFast, bool PosLimits, bool Stats = false, bool Profile = false, bool Jerk = false, bool Mailbox = false, bool SubSteps = false>
+struct Derivs_Limiter_Features {
+    static const bool pointers = Pointers;
+    static const bool preventGoingWrongWay = PreventGoingWrongWay;
+    static const bool preventGoingTooFast = PreventGoingTooFast;
+    static const bool posLimits = PosLimits;
+    static const bool stats = Stats;
+    static const bool profile = Profile;
+    static const bool jerk = Jerk;
+    static const bool mailbox = Mailbox;
+    static const bool subSteps = SubSteps;
+};
+
+typedef Derivs_Limiter_Features<true, true, true, true> Derivs_Limiter_All_Features;
+typedef Derivs_Limiter_Features<false, false, false, false> Derivs_Limiter_Basic_Features;
+typedef Derivs_Limiter_Features<true, true, true, true, true> Derivs_Limiter_Stats_Features; // all features and stats
+typedef Derivs_Limiter_Features<true, true, true, true, false, true> Derivs_Limiter_Profile_Features; // all features and setProfile()
+typedef Derivs_Limiter_Features<true, true, true, true, false, false, true> Derivs_Limiter_Jerk_Features; // all features and setJerkLimit()
+typedef Derivs_Limiter_Features<true, true, true, true, false, false, false, true> Derivs_Limiter_Mailbox_Features; // all features and setMailbox()
+typedef Derivs_Limiter_Features<true, true, true, true, false, false, false, false, true> Derivs_Limiter_Sub_Step_Features; // all features and setMaxSubStep()
+
+// storage for each optional feature, used as base classes of Derivs_Limiter_T so that a feature that is off takes no space (its value is a static constant)
+
+template <typename Scalar, bool enabled>
+struct Derivs_Limiter_Pointers_Option {
+    Scalar* positionPointer;
+    Scalar* velocityPointer;
+    void storePointers(Scalar* pos, Scalar* vel)
+    {
+        positionPointer = pos;
+        velocityPointer = vel;
+    }
+};
+template <typename Scalar>
+struct Derivs_Limiter_Pointers_Option<Scalar, false> {
+    static constexpr Scalar* positionPointer = NULL;
+    static constexpr Scalar* velocityPointer = NULL;
+    void storePointers(Scalar*, Scalar*) { }
+};
+template <typename Scalar>
+constexpr Scalar* Derivs_Limiter_Pointers_Option<Scalar, false>::positionPointer;
+template <typename Scalar>
+constexpr Scalar* Derivs_Limiter_Pointers_Option<Scalar, false>::velocityPointer;
+
+template <bool enabled>
+struct Derivs_Limiter_Wrong_Way_Option {
     bool preventGoingWrongWay;
+    void storePreventGoingWrongWay(bool value)
+    {
+        preventGoingWrongWay = value;
+    }
+};
+template <>
+struct Derivs_Limiter_Wrong_Way_Option<false> {
+    static const bool preventGoingWrongWay = false;
+    void storePreventGoingWrongWay(bool) { }
+};
+
+template <bool enabled>
+struct Derivs_Limiter_Too_Fast_Option {
     bool preventGoingTooFast;
-    float posLimitLow;
-    float posLimitHigh;
-    float maxStoppingDecel;
-    float lastTarget;
-    float targetDelta;
-    float lastPos;
-    float posDelta;
-    float originalVelLimit;
-    float* positionPointer;
-    float* velocityPointer;
+    void storePreventGoingTooFast(bool value)
+    {
+        preventGoingTooFast = value;
+    }
+};
+template <>
+struct Derivs_Limiter_Too_Fast_Option<false> {
+    static const bool preventGoingTooFast = false;
+    void storePreventGoingTooFast(bool) { }
+};
+
+template <typename Scalar, bool enabled>
+struct Derivs_Limiter_Pos_Limits_Option {
+    Scalar posLimitLow;
+    Scalar posLimitHigh;
+    void storePosLimits(Scalar low, Scalar high)
+    {
+        posLimitLow = low;
+        posLimitHigh = high;
+    }
+};
+template <typename Scalar>
+struct Derivs_Limiter_Pos_Limits_Option<Scalar, false> {
+    static constexpr Scalar posLimitLow = -INFINITY;
+    static constexpr Scalar posLimitHigh = INFINITY;
+    void storePosLimits(Scalar, Scalar) { }
+};
+template <typename Scalar>
+constexpr Scalar Derivs_Limiter_Pos_Limits_Option<Scalar, false>::posLimitLow;
+template <typename Scalar>
+constexpr Scalar Derivs_Limiter_Pos_Limits_Option<Scalar, false>::posLimitHigh;
+
+template <typename Scalar, bool enabled>
+struct Derivs_Limiter_Jerk_Option {
+    Scalar jerkLimit;
+    void storeJerkLimit(Scalar value)
+    {
+        jerkLimit = value;
+    }
+};
+template <typename Scalar>
+struct Derivs_Limiter_Jerk_Option<Scalar, false> {
+    static constexpr Scalar jerkLimit = INFINITY;
+    void storeJerkLimit(Scalar) { }
+};
+template <typename Scalar>
+constexpr Scalar Derivs_Limiter_Jerk_Option<Scalar, false>::jerkLimit;
+
+template <typename Scalar, bool enabled>
+struct Derivs_Limiter_Sub_Steps_Option {
+    Scalar maxSubStep;
+    unsigned int maxSubSteps;
+    void storeMaxSubStep(Scalar step, unsigned int steps)
+    {
+        maxSubStep = step;
+        maxSubSteps = steps;
+    }
+};
+template <typename Scalar>
+struct Derivs_Limiter_Sub_Steps_Option<Scalar, false> {
+    static constexpr Scalar maxSubStep = INFINITY;
+    static const unsigned int maxSubSteps = 1;
+    void storeMaxSubStep(Scalar, unsigned int) { }
+};
+template <typename Scalar>
+constexpr Scalar Derivs_Limiter_Sub_Steps_Option<Scalar, false>::maxSubStep;
+template <typename Scalar>
+const unsigned int Derivs_Limiter_Sub_Steps_Option<Scalar, false>::maxSubSteps;
+
+template <typename Scalar, bool enabled>
+class Derivs_Limiter_Stats_Option {
+protected:
+    Derivs_Limiter_Stats_T<Scalar> stats;
+    Scalar overrunDt;
+
+public:
+    Derivs_Limiter_Stats_Option()
+    {
+        overrunDt = INFINITY;
+    }
+
+    /**
+     * @brief  what this Derivs_Limiter has done since the stats were last reset
+     * @note   only counted if Features has Stats (like Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Stats_Features>), otherwise everything is 0
+     * @retval (Derivs_Limiter_Stats) a copy
+     */
+    Derivs_Limiter_Stats_T<Scalar> getStats()
+    {
+        return stats;
+    }
+
+    /**
+     * @brief  getStats() and resetStats() together, so nothing is missed between them
+     * @retval (Derivs_Limiter_Stats) a copy of the stats before they were reset
+     */
+    Derivs_Limiter_Stats_T<Scalar> takeStats()
+    {
+        Derivs_Limiter_Stats_T<Scalar> ret = stats;
+        stats.reset();
+        return ret;
+    }
+
+    /**
+     * @brief  set every stat back to 0
+     * @retval None
+     */
+    void resetStats()
+    {
+        stats.reset();
+    }
+
+    /**
+     * @brief  calculations with a time interval longer than this are counted as overruns in the stats
+     * @param  seconds: (float) default INFINITY (none counted), ignored if NAN
+     * @retval None
+     */
+    void setOverrunThreshold(Scalar seconds)
+    {
+        if (!isnan(seconds))
+            overrunDt = seconds;
+    }
+
+    /**
+     * @brief  get the overrun threshold, see setOverrunThreshold()
+     * @retval (float) seconds
+     */
+    Scalar getOverrunThreshold()
+    {
+        return overrunDt;
+    }
+
+protected:
+    void recordStep(Scalar dt)
+    {
+        if (!(dt > 0)) {
+            stats.skippedSteps++;
+            return;
+        }
+        stats.steps++;
+        stats.totalDt += dt;
+        if (dt < stats.minDt)
+            stats.minDt = dt;
+        if (dt > stats.maxDt)
+            stats.maxDt = dt;
+        if (dt > overrunDt)
+            stats.overruns++;
+    }
+    void recordRegime(Derivs_Limiter_Kernel::Regime regime)
+    {
+        stats.regimes[regime]++;
+    }
+    void recordProfileStep()
+    {
+        stats.profileSteps++;
+    }
+    void recordMicros(unsigned long us)
+    {
+        stats.calcMicros += us;
+    }
+};
+template <typename Scalar>
+class Derivs_Limiter_Stats_Option<Scalar, false> {
+public:
+    Derivs_Limiter_Stats_T<Scalar> getStats() { return Derivs_Limiter_Stats_T<Scalar>(); }
+    Derivs_Limiter_Stats_T<Scalar> takeStats() { return Derivs_Limiter_Stats_T<Scalar>(); }
+    void resetStats() { }
+    void setOverrunThreshold(Scalar) { }
+    Scalar getOverrunThreshold() { return INFINITY; }
+
+protected:
+    void recordStep(Scalar) { }
+    void recordRegime(Derivs_Limiter_Kernel::Regime) { }
+    void recordProfileStep() { }
+    void recordMicros(unsigned long) { }
+};
+
+// the version with Profile on is in Derivs_Limiter_Profile.h, next to Derivs_Limiter_Profile_T
+template <typename Scalar, bool enabled>
+struct Derivs_Limiter_Profile_Option;
+template <typename Scalar>
+struct Derivs_Limiter_Profile_Option<Scalar, false> {
+    void storeProfile(Derivs_Limiter_Profile_T<Scalar>*) { }
+    bool stepProfile(Scalar&, Scalar&, Scalar&, Scalar, Scalar, Scalar, Scalar, Scalar) { return false; }
+};
+
+// the version with Mailbox on is in Derivs_Limiter_Mailbox.h, next to Derivs_Limiter_Mailbox_T
+template <typename Scalar, bool enabled>
+struct Derivs_Limiter_Mailbox_Option;
+template <typename Scalar>
+struct Derivs_Limiter_Mailbox_Option<Scalar, false> {
+    void storeMailbox(Derivs_Limiter_Mailbox_T<Scalar>*) { }
+    bool isMailboxPending() { return false; }
+    template <typename Limiter>
+    void takeCommand(Limiter&) { }
+};
+
+/**
+ * @brief  everything Derivs_Limiter does, as a CRTP base class: extend it by deriving from it instead of overriding the virtual _calc() of Derivs_Limiter_T
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   Derived can declare (public) any of these, they hide the empty defaults and are called directly, so they can be inlined into the calculation:
+ *         void preStep(Scalar dt), run every calculation before position and velocity are calculated (after the time check and pointers are read), for example to clamp target;
+ *         void postStep(Scalar dt), run every calculation after they're calculated (before pointers are written), for example to map position to an output;
+ *         Scalar _calc(), to replace how calc() reads the clock.
+ *         class MyAxis : public Derivs_Limiter_Base<MyAxis> { public: void postStep(float dt) { ... } };
+ *         There's no virtual function, so no vtable pointer in each object. Derivs_Limiter_T is this class with a virtual _calc(), for subclasses written for older versions.
+ * @tparam Derived: the class deriving from this one
+ * @tparam Scalar: type used for every value, float or double
+ * @tparam Clock: type with a static unsigned long now() function that returns microseconds (or another unit, see Derivs_Limiter_Clock_Rate)
+ * @tparam Features: Derivs_Limiter_Features, which optional features are compiled in, default all of them
+ */
+template <typename Derived, typename Scalar = float, typename Clock = Derivs_Limiter_Micros_Clock, typename Features = Derivs_Limiter_All_Features>
+class Derivs_Limiter_Base : protected Derivs_Limiter_Pointers_Option<Scalar, Features::pointers>,
+                            protected Derivs_Limiter_Wrong_Way_Option<Features::preventGoingWrongWay>,
+                            protected Derivs_Limiter_Too_Fast_Option<Features::preventGoingTooFast>,
+                            protected Derivs_Limiter_Pos_Limits_Option<Scalar, Features::posLimits>,
+                            protected Derivs_Limiter_Stats_Option<Scalar, Features::stats>,
+                            protected Derivs_Limiter_Profile_Option<Scalar, Features::profile>,
+                            protected Derivs_Limiter_Jerk_Option<Scalar, Features::jerk>,
+                            protected Derivs_Limiter_Mailbox_Option<Scalar, Features::mailbox>,
+                            protected Derivs_Limiter_Sub_Steps_Option<Scalar, Features::subSteps> {
+protected:
+    typedef Derivs_Limiter_Pointers_Option<Scalar, Features::pointers> PointersOption;
+    typedef Derivs_Limiter_Wrong_Way_Option<Features::preventGoingWrongWay> WrongWayOption;
+    typedef Derivs_Limiter_Too_Fast_Option<Features::preventGoingTooFast> TooFastOption;
+    typedef Derivs_Limiter_Pos_Limits_Option<Scalar, Features::posLimits> PosLimitsOption;
+    typedef Derivs_Limiter_Stats_Option<Scalar, Features::stats> StatsOption;
+    typedef Derivs_Limiter_Profile_Option<Scalar, Features::profile> ProfileOption;
+    typedef Derivs_Limiter_Jerk_Option<Scalar, Features::jerk> JerkOption;
+    typedef Derivs_Limiter_Mailbox_Option<Scalar, Features::mailbox> MailboxOption;
+    typedef Derivs_Limiter_Sub_Steps_Option<Scalar, Features::subSteps> SubStepsOption;
+    using PointersOption::positionPointer;
+    using PointersOption::velocityPointer;
+    using PointersOption::storePointers;
+    using WrongWayOption::preventGoingWrongWay;
+    using WrongWayOption::storePreventGoingWrongWay;
+    using TooFastOption::preventGoingTooFast;
+    using TooFastOption::storePreventGoingTooFast;
+    using PosLimitsOption::posLimitLow;
+    using PosLimitsOption::posLimitHigh;
+    using PosLimitsOption::storePosLimits;
+    using StatsOption::recordStep;
+    using StatsOption::recordRegime;
+    using StatsOption::recordProfileStep;
+    using StatsOption::recordMicros;
+    using ProfileOption::storeProfile;
+    using ProfileOption::stepProfile;
+    using JerkOption::jerkLimit;
+    using JerkOption::storeJerkLimit;
+    using MailboxOption::storeMailbox;
+    using MailboxOption::isMailboxPending;
+    using MailboxOption::takeCommand;
+    using SubStepsOption::maxSubStep;
+    using SubStepsOption::maxSubSteps;
+    using SubStepsOption::storeMaxSubStep;
+
+    Scalar position;
+    Scalar velocity;
+    Scalar accel;
+    unsigned long lastTime;
+    Scalar target;
+    Scalar velLimit;
+    Scalar accelLimit;
+    Scalar decelLimit;
+    Scalar time;
+    Scalar maxStoppingDecel;
+    Scalar lastTarget;
+    Scalar targetDelta;
+    Scalar lastPos;
+    Scalar posDelta;
+    Scalar originalVelLimit;
     bool posMode;
-    float velocityTarget;
+    Scalar velocityTarget;
 
 public:
+    typedef Scalar ScalarType; // for classes that take the limiter type as a template parameter, like Derivs_Limiter_Group
+    typedef Clock ClockType; // for classes that read the same clock as the limiter, like Derivs_Limiter_Stepper
+
+    using StatsOption::getStats;
+    using StatsOption::takeStats;
+    using StatsOption::resetStats;
+    using StatsOption::setOverrunThreshold;
+    using StatsOption::getOverrunThreshold;
+
     /**
      * @brief  constructor for Derivs_Limiter class
      * @param  _velLimit: (float) velocity limit (units per second)
@@ -48,10 +918,10 @@ public:
      * @param  _posPointer: set pointer to an external variable that will be read and modified during calc as position.  use &var
      * @param  _velPointer: set pointer to an external variable that will be read and modified during calc as velocity.  use &var
      */
-    Derivs_Limiter(float _velLimit, float _accelLimit, float _decelLimit = NAN, float _target = 0,
-        float _startPos = 0, float _startVel = 0, bool _preventGoingWrongWay = false, bool _preventGoingTooFast = false,
-        float _posLimitLow = -INFINITY, float _posLimitHigh = INFINITY, float _maxStoppingDecel = 2,
-        float* _posPointer = NULL, float* _velPointer = NULL)
+    Derivs_Limiter_Base(Scalar _velLimit, Scalar _accelLimit, Scalar _decelLimit = NAN, Scalar _target = 0,
+        Scalar _startPos = 0, Scalar _startVel = 0, bool _preventGoingWrongWay = false, bool _preventGoingTooFast = false,
+        Scalar _posLimitLow = -INFINITY, Scalar _posLimitHigh = INFINITY, Scalar _maxStoppingDecel = 2,
+        Scalar* _posPointer = NULL, Scalar* _velPointer = NULL)
     {
         accel = 0;
         lastTime = 0;
@@ -74,21 +944,23 @@ public:
         if (!isnan(_startVel))
             velocity = _startVel;
         time = 0;
-        preventGoingWrongWay = _preventGoingWrongWay;
-        preventGoingTooFast = _preventGoingTooFast;
-        posLimitLow = _posLimitLow;
-        posLimitHigh = max(_posLimitHigh, posLimitLow);
-        maxStoppingDecel = max(_maxStoppingDecel, (float)1.0);
-        positionPointer = _posPointer;
-        velocityPointer = _velPointer;
+        storePreventGoingWrongWay(_preventGoingWrongWay);
+        storePreventGoingTooFast(_preventGoingTooFast);
+        storePosLimits(_posLimitLow, max(_posLimitHigh, _posLimitLow));
+        maxStoppingDecel = max(_maxStoppingDecel, (Scalar)1.0);
+        storePointers(_posPointer, _velPointer);
         velocityTarget = 0;
+        storeJerkLimit(INFINITY);
+        storeMaxSubStep(INFINITY, 1);
+        storeProfile(NULL);
+        storeMailbox(NULL);
     }
 
     /**
      * @brief  default constructor for Derivs_Limiter
      * @note  make sure to use the normal constructor after this, this constructor is only to allow arrays of Derivs_Limiters
      */
-    Derivs_Limiter()
+    Derivs_Limiter_Base()
     {
         accel = 0;
         lastTime = 0;
@@ -105,14 +977,16 @@ public:
         posDelta = 0;
         velocity = 0;
         time = 0;
-        preventGoingWrongWay = false;
-        preventGoingTooFast = false;
-        posLimitLow = 0;
-        posLimitHigh = 0;
+        storePreventGoingWrongWay(false);
+        storePreventGoingTooFast(false);
+        storePosLimits(0, 0);
         maxStoppingDecel = 1;
-        positionPointer = NULL;
-        velocityPointer = NULL;
+        storePointers(NULL, NULL);
         velocityTarget = 0;
+        storeJerkLimit(INFINITY);
+        storeMaxSubStep(INFINITY, 1);
+        storeProfile(NULL);
+        storeMailbox(NULL);
     }
 
     /**
@@ -121,7 +995,7 @@ public:
      * @param  vel: (float) default: 0, ignored if NAN
      * @retval None
      */
-    void setPositionVelocity(float pos = 0, float vel = 0)
+    void setPositionVelocity(Scalar pos = 0, Scalar vel = 0)
     {
         if (!isnan(pos))
             position = pos;
@@ -135,7 +1009,7 @@ public:
      * @param  pos: (float) default: 0, ignored if NAN
      * @retval None
      */
-    void setTargetAndPosition(float targ = 0, float pos = 0)
+    void setTargetAndPosition(Scalar targ = 0, Scalar pos = 0)
     {
         if (!isnan(targ)) {
             target = targ;
@@ -150,7 +1024,7 @@ public:
      * @param  pos: (float) default: 0, ignored if NAN
      * @retval (bool) true if position changed
      */
-    bool setPosition(float pos = 0)
+    bool setPosition(Scalar pos = 0)
     {
         if (pos != position) {
             if (!isnan(pos)) {
@@ -167,7 +1041,7 @@ public:
      * @param  vel: (float) default: 0, ignored if NAN
      * @retval (bool) true if velocity changed
      */
-    bool setVelocity(float vel = 0)
+    bool setVelocity(Scalar vel = 0)
     {
         if (vel != velocity) {
             if (!isnan(vel)) {
@@ -183,7 +1057,7 @@ public:
      * @param  velLim: (float) velocity limit (units per second)
      * @retval (bool) true if limit changed
      */
-    bool setVelLimit(float velLim)
+    bool setVelLimit(Scalar velLim)
     {
         if (velLim != velLimit) {
             velLimit = abs(velLim);
@@ -198,7 +1072,7 @@ public:
      * @param  accelLim: (float) acceleration limit (units per second per second)
      * @retval (bool) true if limit changed
      */
-    bool setAccelLimit(float accelLim)
+    bool setAccelLimit(Scalar accelLim)
     {
         if (accelLim != accelLimit) {
             accelLimit = abs(accelLim);
@@ -212,7 +1086,7 @@ public:
      * @param  _decelLimit: (float) deceleration limit, if NAN decelLimit gets set to accelLimit
      * @retval None
      */
-    void setDecelLimit(float _decelLimit = NAN)
+    void setDecelLimit(Scalar _decelLimit = NAN)
     {
         if (isnan(_decelLimit)) { // decelLimit defaults to accelLimit
             decelLimit = accelLimit;
@@ -222,36 +1096,95 @@ public:
     }
 
     /**
-     * @brief combines setAccelLimit() with setDecelLimit()
-     * @param  _accelLimit:
-     * @param  _decelLimit:
+     * @brief combines setAccelLimit() with setDecelLimit()
+     * @param  _accelLimit:
+     * @param  _decelLimit:
+     * @retval None
+     */
+    void setAccelAndDecelLimits(Scalar _accelLimit, Scalar _decelLimit = NAN)
+    {
+        setAccelLimit(_accelLimit);
+        setDecelLimit(_decelLimit);
+    }
+
+    /**
+     * @brief  set velocity and acceleration limits
+     * @param  velLim: (float) velocity limit
+     * @param  accLim: (float) acceleration limit
+     * @param  decLim: (float) deceleration limit, set NAN to set equal to acceleration limit
+     * @retval None
+     */
+    void setVelAccelLimits(Scalar velLim, Scalar accLim, Scalar decLim = NAN)
+    {
+        setVelLimit(velLim);
+        setAccelLimit(accLim);
+        setDecelLimit(decLim);
+    }
+
+    /**
+     * @brief  set jerk limit, how fast acceleration can change, in position and velocity mode
+     * @note   INFINITY (the default) means acceleration can change instantly. With a jerk limit, moves take a little longer but acceleration ramps up and down smoothly, and getAcceleration() is no longer noisy.
+     *         A profile set with setProfile() is not used while there's a jerk limit.
+     *         Only used if Features has Jerk (like Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Jerk_Features>), otherwise this does nothing.
+     * @param  jerkLim: (float) jerk limit (units per second per second per second), ignored if NAN
+     * @retval None
+     */
+    void setJerkLimit(Scalar jerkLim)
+    {
+        if (!isnan(jerkLim))
+            storeJerkLimit(abs(jerkLim));
+    }
+
+    /**
+     * @brief  get jerk limit setting
+     * @retval  (float)
+     */
+    Scalar getJerkLimit()
+    {
+        return jerkLimit;
+    }
+
+    /**
+     * @brief  split long time intervals into shorter sub-steps, so a loop that stalls (or runs slowly) doesn't overshoot or snap to the target
+     * @note   INFINITY (the default) turns this off. Each calculation with a time interval longer than maxSubStep is done as several equal sub-steps no longer than maxSubStep,
+     *         so the result depends much less on how often calc() is called. Pointers, the mailbox, the hooks, and the deltas are still handled once per calculation.
+     *         maxSubSteps bounds the time a calculation can take after a long stall, longer intervals are split into maxSubSteps longer sub-steps.
+     *         A move that follows a profile (see setProfile()) is exact for any interval, so splitting only matters once it falls back to the normal calculation.
+     *         Only used if Features has SubSteps (like Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Sub_Step_Features>), otherwise this does nothing.
+     * @param  _maxSubStep: (float) longest sub-step in seconds, ignored if NAN or not greater than 0
+     * @param  _maxSubSteps: (unsigned int) default=100, most sub-steps in one calculation, at least 1
      * @retval None
      */
-    void setAccelAndDecelLimits(float _accelLimit, float _decelLimit = NAN)
+    void setMaxSubStep(Scalar _maxSubStep, unsigned int _maxSubSteps = 100)
     {
-        setAccelLimit(_accelLimit);
-        setDecelLimit(_decelLimit);
+        if (!(_maxSubStep > 0)) // also catches NAN
+            return;
+        storeMaxSubStep(_maxSubStep, max(_maxSubSteps, 1u));
     }
 
     /**
-     * @brief  set velocity and acceleration limits
-     * @param  velLim: (float) velocity limit
-     * @param  accLim: (float) acceleration limit
-     * @param  decLim: (float) deceleration limit, set NAN to set equal to acceleration limit
-     * @retval None
+     * @brief  get the longest sub-step setting, INFINITY if long intervals aren't split
+     * @retval (float)
      */
-    void setVelAccelLimits(float velLim, float accLim, float decLim = NAN)
+    Scalar getMaxSubStep()
     {
-        setVelLimit(velLim);
-        setAccelLimit(accLim);
-        setDecelLimit(decLim);
+        return maxSubStep;
+    }
+
+    /**
+     * @brief  get the most sub-steps in one calculation
+     * @retval (unsigned int)
+     */
+    unsigned int getMaxSubSteps()
+    {
+        return maxSubSteps;
     }
 
     /**
      * @brief  get velocity limit setting
      * @retval  (float)
      */
-    float getVelLimit()
+    Scalar getVelLimit()
     {
         return velLimit;
     }
@@ -260,7 +1193,7 @@ public:
      * @brief  get acceleration limit setting
      * @retval  (float)
      */
-    float getAccelLimit()
+    Scalar getAccelLimit()
     {
         return accelLimit;
     }
@@ -269,7 +1202,7 @@ public:
      * @brief  get deceleration limit setting
      * @retval  (float)
      */
-    float getDecelLimit()
+    Scalar getDecelLimit()
     {
         return decelLimit;
     }
@@ -278,7 +1211,7 @@ public:
      * @brief  get the current velocity
      * @retval (float) (units per second)
      */
-    float getVelocity()
+    Scalar getVelocity()
     {
         return velocity;
     }
@@ -288,7 +1221,7 @@ public:
      * @note for debugging only, value noisy
      * @retval (float) (units per second per second)
      */
-    float getAcceleration()
+    Scalar getAcceleration()
     {
         return accel;
     }
@@ -297,7 +1230,7 @@ public:
      * @brief  get the current position value, but doesn't calculate anything
      * @retval (float)
      */
-    float getPosition()
+    Scalar getPosition()
     {
         return position;
     }
@@ -307,16 +1240,16 @@ public:
      * @param  _maxStoppingDecel: (float) must be >=1.0, can be INFINITY
      * @retval None
      */
-    void setMaxStoppingDecel(float _maxStoppingDecel)
+    void setMaxStoppingDecel(Scalar _maxStoppingDecel)
     {
-        maxStoppingDecel = max(_maxStoppingDecel, (float)1.0);
+        maxStoppingDecel = max(_maxStoppingDecel, (Scalar)1.0);
     }
 
     /**
      * @brief  get setting for how many times accelLimit can be used to stop in time for target position
      * @retval (float)
      */
-    float getMaxStoppingDecel()
+    Scalar getMaxStoppingDecel()
     {
         return maxStoppingDecel;
     }
@@ -325,7 +1258,7 @@ public:
      * @brief  get the lower boundary for position
      * @retval (float)
      */
-    float getLowPosLimit()
+    Scalar getLowPosLimit()
     {
         return posLimitLow;
     }
@@ -334,7 +1267,7 @@ public:
      * @brief  get the higher boundary for position
      * @retval (float)
      */
-    float getHighPosLimit()
+    Scalar getHighPosLimit()
     {
         return posLimitHigh;
     }
@@ -345,10 +1278,10 @@ public:
      * @param  lowLimit: (float), -INFINITY means no limit
      * @retval (bool) did boundary change (was it valid)
      */
-    bool setLowPosLimit(float lowLimit)
+    bool setLowPosLimit(Scalar lowLimit)
     {
         if (lowLimit < posLimitHigh) {
-            posLimitLow = lowLimit;
+            storePosLimits(lowLimit, posLimitHigh);
             return true;
         }
         return false;
@@ -360,10 +1293,10 @@ public:
      * @param  highLimit: (float), INFINITY means no limit
      * @retval (bool) did boundary change (was it valid)
      */
-    bool setHighPosLimit(float highLimit)
+    bool setHighPosLimit(Scalar highLimit)
     {
         if (highLimit > posLimitLow) {
-            posLimitHigh = highLimit;
+            storePosLimits(posLimitLow, highLimit);
             return true;
         }
         return false;
@@ -375,7 +1308,7 @@ public:
      * @param  highLimit: (float)
      * @retval None
      */
-    void setPosLimits(float lowLimit, float highLimit)
+    void setPosLimits(Scalar lowLimit, Scalar highLimit)
     {
         setLowPosLimit(lowLimit);
         setHighPosLimit(highLimit);
@@ -386,7 +1319,7 @@ public:
      * @param  _target: (float) position, ignored if NAN
      * @retval  (bool) position==target
      */
-    bool setTarget(float _target)
+    bool setTarget(Scalar _target)
     {
         if (!isnan(_target)) {
             target = _target;
@@ -399,7 +1332,7 @@ public:
      * @brief  get target position
      * @retval  (float)
      */
-    float getTarget()
+    Scalar getTarget()
     {
         return target;
     }
@@ -409,7 +1342,7 @@ public:
      * @param  targPos: (float)
      * @retval None
      */
-    void setPositionAndTarget(float targPos)
+    void setPositionAndTarget(Scalar targPos)
     {
         setPosition(targPos);
         setTarget(targPos);
@@ -420,7 +1353,7 @@ public:
      * @param  increment: (float)
      * @retval None
      */
-    void jogPosition(float increment)
+    void jogPosition(Scalar increment)
     {
         velocity = 0;
         setPositionAndTarget(position + increment);
@@ -432,11 +1365,11 @@ public:
      */
     void resetTime()
     {
-        lastTime = micros();
+        lastTime = Clock::now();
     }
 
     /**
-     * @brief  returns the value of micros() when calc() last ran
+     * @brief  returns the value of the clock (micros() by default) when calc() last ran
      * @retval  unsigned long
      */
     unsigned long getLastTime()
@@ -448,7 +1381,7 @@ public:
      * @brief  returns the time (in seconds) between the two most recent calculation times
      * @retval  (float)
      */
-    float getTimeInterval()
+    Scalar getTimeInterval()
     {
         return time;
     }
@@ -457,7 +1390,7 @@ public:
      * @brief  returns the change in target from the most recent run of calc()
      * @retval  (float)
      */
-    float getTargetDelta()
+    Scalar getTargetDelta()
     {
         return targetDelta;
     }
@@ -466,7 +1399,7 @@ public:
      * @brief  what was target in the most recent run of calc()
      * @retval  (float)
      */
-    float getLastTarget()
+    Scalar getLastTarget()
     {
         return lastTarget;
     }
@@ -475,7 +1408,7 @@ public:
      * @brief  returns the change in position from the most recent run of calc()
      * @retval  (float)
      */
-    float getPositionDelta()
+    Scalar getPositionDelta()
     {
         return posDelta;
     }
@@ -484,7 +1417,7 @@ public:
      * @brief  what was position in the most recent run of calc(), can be used to see if position was changed outside of calc()
      * @retval  (float)
      */
-    float getLastPosition()
+    Scalar getLastPosition()
     {
         return lastPos;
     }
@@ -494,7 +1427,7 @@ public:
      * @note   returns 0 if time is 0
      * @retval (float)
      */
-    float getTargetDeltaPerTime()
+    Scalar getTargetDeltaPerTime()
     {
         if (time > 0)
             return targetDelta / time;
@@ -507,9 +1440,9 @@ public:
      * @param  _positionPointer: (float*)
      * @retval None
      */
-    void setPositionPointer(float* _positionPointer)
+    void setPositionPointer(Scalar* _positionPointer)
     {
-        positionPointer = _positionPointer;
+        storePointers(_positionPointer, velocityPointer);
     }
 
     /**
@@ -518,9 +1451,57 @@ public:
      * @param  _velocityPointer: (float*)
      * @retval None
      */
-    void setVelocityPointer(float* _velocityPointer)
+    void setVelocityPointer(Scalar* _velocityPointer)
+    {
+        storePointers(positionPointer, _velocityPointer);
+    }
+
+    /**
+     * @brief  set a Derivs_Limiter_Profile to use, then each new target is reached by following a precomputed trapezoidal profile instead of the normal calculation
+     * @note   set to NULL to not use, set with setProfile(&profile). The normal calculation is used for the rest of a move if position, velocity, or a limit changes during it, see Derivs_Limiter_Profile
+     *         Only used if Features has Profile (like Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Profile_Features>), otherwise this does nothing.
+     * @param  _profile: (Derivs_Limiter_Profile*)
+     * @retval None
+     */
+    void setProfile(Derivs_Limiter_Profile_T<Scalar>* _profile)
+    {
+        storeProfile(_profile);
+    }
+
+    /**
+     * @brief  set a Derivs_Limiter_Mailbox to use, then commands posted to it from another thread, core, or interrupt are applied at the start of the next calculation
+     * @note   set to NULL to not use, set with setMailbox(&mailbox). Neither side ever waits for the other, see Derivs_Limiter_Mailbox
+     *         Only used if Features has Mailbox (like Derivs_Limiter_T<float, Derivs_Limiter_Micros_Clock, Derivs_Limiter_Mailbox_Features>), otherwise this does nothing.
+     * @param  _mailbox: (Derivs_Limiter_Mailbox*)
+     * @retval None
+     */
+    void setMailbox(Derivs_Limiter_Mailbox_T<Scalar>* _mailbox)
     {
-        velocityPointer = _velocityPointer;
+        storeMailbox(_mailbox);
+    }
+
+    /**
+     * @brief  make every change in a command: limits first, then target (position mode) or velTarget (velocity mode)
+     * @note   this is what is done with commands from the mailbox, values that are NAN aren't changed (needs Derivs_Limiter_Mailbox.h, any Features)
+     * @param  command: (Derivs_Limiter_Command)
+     * @retval None
+     */
+    void applyCommand(const Derivs_Limiter_Command_T<Scalar>& command)
+    {
+        if (!isnan(command.velLimit)) {
+            setVelLimit(command.velLimit);
+        }
+        if (!isnan(command.accelLimit)) {
+            setAccelLimit(command.accelLimit);
+        }
+        if (!isnan(command.decelLimit)) {
+            setDecelLimit(command.decelLimit);
+        }
+        if (!isnan(command.target)) {
+            setTarget(command.target);
+        } else if (!isnan(command.velTarget)) {
+            setVelTarget(command.velTarget);
+        }
     }
 
     /**
@@ -530,7 +1511,7 @@ public:
      */
     void setPreventGoingWrongWay(bool _preventGoingWrongWay)
     {
-        preventGoingWrongWay = _preventGoingWrongWay;
+        storePreventGoingWrongWay(_preventGoingWrongWay);
     }
 
     /**
@@ -549,7 +1530,7 @@ public:
      */
     void setPreventGoingTooFast(bool _preventGoingTooFast)
     {
-        preventGoingTooFast = _preventGoingTooFast;
+        storePreventGoingTooFast(_preventGoingTooFast);
     }
 
     /**
@@ -584,17 +1565,170 @@ public:
      * @note use abs(distToTarget()) if you don't care about direction
      * @retval (float)
      */
-    float distToTarget()
+    Scalar distToTarget()
     {
         return target - position;
     }
 
+    /**
+     * @brief  how long until position reaches target and stops, calculated from the current state and limits without running calc()
+     * @note   includes slowing down first if moving the wrong way or faster than velLimit, and passing the target and coming back if it can't stop in time.
+     *         calc() arrives within about 40 time intervals of it (its last approach to the target takes a few intervals longer than braking at decelLimit). It doesn't include a jerk limit.
+     *         Not supported: with preventGoingWrongWay, if it can't stop before the target even at maxStoppingDecel, this is only the time until it passes the target.
+     *         calc() then stops wherever its last step went past the target and comes back from there, which takes a time that depends on the time interval.
+     * @retval (float) seconds, INFINITY in velocity mode or if the limits don't let it get there
+     */
+    Scalar getTimeToTarget()
+    {
+        if (!posMode) {
+            return INFINITY;
+        }
+        Scalar toTarget = constrain(target, posLimitLow, posLimitHigh) - position;
+        Scalar speed = (toTarget >= 0) ? velocity : -velocity; // towards target
+        if (preventGoingTooFast) {
+            speed = constrain(speed, -velLimit, velLimit);
+        }
+        Scalar dist = abs(toTarget);
+        if (dist == 0) { // calc() stops at the target even if moving (unless faster than velLimit)
+            return 0;
+        }
+        if (speed < 0) { // going the wrong way, stop then come back
+            if (preventGoingWrongWay) {
+                return _timeToTarget(dist, 0);
+            }
+            Scalar stopTime = (decelLimit == INFINITY) ? 0 : abs(speed) / decelLimit;
+            Scalar stopDist = (decelLimit == INFINITY) ? 0 : sq(speed) / 2 / decelLimit;
+            return stopTime + _timeToTarget(dist + stopDist, 0);
+        }
+        return _timeToTarget(dist, speed);
+    }
+
+    /**
+     * @brief  how long it takes to stop (velocity reaching 0) slowing down at decelLimit
+     * @note   doesn't include a jerk limit
+     * @retval (float) seconds
+     */
+    Scalar getTimeToStop()
+    {
+        Scalar speed = abs(velocity);
+        if (preventGoingTooFast) {
+            speed = min(speed, velLimit);
+        }
+        if (speed == 0 || decelLimit == INFINITY) {
+            return 0;
+        }
+        return speed / decelLimit;
+    }
+
+    /**
+     * @brief  will calc() leave everything unchanged until something is set? (stopped at the target, or stopped with a velocity target of 0)
+     * @note   also false while the mailbox has a command waiting, or the position or velocity pointer's variable was changed since the last calculation
+     * @retval (bool)
+     */
+    bool isIdle()
+    {
+        if (_hasInput()) {
+            return false;
+        }
+        if (posMode) {
+            return velocity == 0 && position == constrain(target, posLimitLow, posLimitHigh);
+        }
+        return velocity == 0 && velocityTarget == 0;
+    }
+
+    /**
+     * @brief  how long until the calculation next changes what it's doing (acceleration ends, deceleration starts, position arrives at the target), calculated from the current state and limits
+     * @note   To save power, sleep until the soonest event of every limiter instead of running calc() continuously, then run calc() and ask again.
+     *         Calculating at the events only is less accurate than calculating often, since each calculation is one step, see setMaxSubStep().
+     *         It doesn't include a jerk limit, or reaching a position limit in velocity mode while still speeding up.
+     * @retval (float) seconds, 0 if the next calculation changes something right away, INFINITY if isIdle() or moving at a constant velocity forever
+     */
+    Scalar getTimeToNextEvent()
+    {
+        if (_hasInput()) {
+            return 0;
+        }
+        if (!posMode) {
+            Scalar velTarget = constrain(velocityTarget, -velLimit, velLimit);
+            if (velocity == velTarget) { // coasting, until a position limit
+                if (velocity > 0 && posLimitHigh != INFINITY) {
+                    return max((posLimitHigh - position) / velocity, (Scalar)0);
+                } else if (velocity < 0 && posLimitLow != -INFINITY) {
+                    return max((posLimitLow - position) / velocity, (Scalar)0);
+                }
+                return INFINITY;
+            }
+            if (velocity == 0) {
+                return abs(velTarget) / accelLimit;
+            }
+            if ((velocity > 0) != (velTarget > 0) || velTarget == 0) { // stopping first
+                return preventGoingWrongWay ? 0 : abs(velocity) / decelLimit;
+            }
+            if (abs(velTarget) > abs(velocity)) {
+                return (abs(velTarget) - abs(velocity)) / accelLimit;
+            }
+            return (abs(velocity) - abs(velTarget)) / decelLimit;
+        }
+
+        Scalar toTarget = constrain(target, posLimitLow, posLimitHigh) - position;
+        Scalar speed = (toTarget >= 0) ? velocity : -velocity; // towards target
+        if (preventGoingTooFast) {
+            speed = constrain(speed, -velLimit, velLimit);
+        }
+        Scalar dist = abs(toTarget);
+        if (dist == 0) { // calc() stops it at the target
+            return (velocity == 0) ? INFINITY : 0;
+        }
+        if (speed < 0) { // going the wrong way, stops then comes back
+            return preventGoingWrongWay ? 0 : -speed / decelLimit;
+        }
+        Scalar brakeDist = (decelLimit == INFINITY) ? 0 : sq(speed) / 2 / decelLimit;
+        if (brakeDist >= dist * (Scalar)0.999) { // slowing down to the target (calc() keeps it just at this point, so allow for rounding), arrives
+            return 2 * dist / speed;
+        }
+        if (speed >= velLimit) { // coasting (or slowing down to velLimit) until it has to slow down for the target
+            if (speed == 0) {
+                return INFINITY;
+            }
+            Scalar brakeTime = (dist - brakeDist) / speed;
+            if (speed > velLimit) {
+                return min((speed - velLimit) / decelLimit, brakeTime);
+            }
+            return brakeTime;
+        }
+        if (accelLimit == 0) {
+            return (speed == 0) ? INFINITY : (dist - brakeDist) / speed;
+        }
+        // speeding up, until reaching velLimit or having to slow down, peak speed from v^2 = u^2 + 2as for both parts
+        Scalar peak;
+        if (accelLimit == INFINITY) {
+            return 0;
+        } else if (decelLimit == INFINITY) {
+            peak = sqrt(sq(speed) + 2 * accelLimit * dist);
+        } else {
+            peak = sqrt((2 * accelLimit * decelLimit * dist + decelLimit * sq(speed)) / (accelLimit + decelLimit));
+        }
+        return (min(peak, velLimit) - speed) / accelLimit;
+    }
+
+    /**
+     * @brief  when the calculation next changes what it's doing, see getTimeToNextEvent()
+     * @note   measured from the time of the last calc() (getLastTime()), so only useful with calc(). With step(dt) use getTimeToNextEvent().
+     *         When there's no event it's at most about 35 minutes away, so it can be compared with micros() even after micros() overflows.
+     * @retval (unsigned long) microseconds, on the same clock as micros() (or in the Clock's units, see Derivs_Limiter_Clock_Rate)
+     */
+    unsigned long getNextEventTime()
+    {
+        Scalar t = getTimeToNextEvent() * (Scalar)Derivs_Limiter_Clock_Rate<Clock>::ticksPerSecond;
+        return lastTime + (unsigned long)min(t, (Scalar)2147483647.0);
+    }
+
     /**
      * @brief  switch to velocity mode, and set velocity immediately to a constant value.
      * @param  vel: (float)
      * @retval None
      */
-    void setVelConstant(float vel)
+    void setVelConstant(Scalar vel)
     {
         if (isnan(vel)) {
             return;
@@ -609,7 +1743,7 @@ public:
      * @param  vel: (float)
      * @retval None
      */
-    void setVelTarget(float vel)
+    void setVelTarget(Scalar vel)
     {
         if (isnan(vel)) {
             return;
@@ -631,7 +1765,7 @@ public:
      * @brief  get the target velocity used by the velocity control mode
      * @retval (float)
      */
-    float getVelTarget()
+    Scalar getVelTarget()
     {
         return velocityTarget;
     }
@@ -654,7 +1788,7 @@ public:
      * @param  _maxVel: (float, optional, default=NAN) maximum allowable velocity, if the required velocity exceeds this the function returns false, if NAN the velocity limit set in the constructor or setVelLimit() is used
      * @retval (bool) true if move possible within time given acceleration limit, false if not possible (and nothing is changed)
      */
-    boolean setVelLimitForTimedMove(float _dist, float _time, float _maxVel = NAN)
+    boolean setVelLimitForTimedMove(Scalar _dist, Scalar _time, Scalar _maxVel = NAN)
     {
         if (isnan(_dist) || isnan(_time)) {
             return false;
@@ -663,19 +1797,10 @@ public:
         _time = abs(_time);
         if (isnan(_maxVel))
             _maxVel = originalVelLimit;
-        float tempVelLimit;
-        if (accelLimit == INFINITY && decelLimit == INFINITY)
-            tempVelLimit = _dist / _time;
-        else {
-            float acc;
-            if (accelLimit == INFINITY && decelLimit != INFINITY)
-                acc = decelLimit * 2;
-            else if (accelLimit != INFINITY && decelLimit == INFINITY)
-                acc = accelLimit * 2;
-            else
-                acc = sqrt(decelLimit * accelLimit); // find single acceleration that takes equivalent time to the two different limits.
-            tempVelLimit = (-0.5 * acc * (-_time + sqrt(sq(_time) - 4 * _dist / acc)));
-        }
+        // a trapezoid move at velocity v takes _time = _dist / v + v * k / 2, where k = 1 / accelLimit + 1 / decelLimit (the time to speed up and slow down per unit of velocity),
+        // solved for the lower v (the one with a cruise part). Written so it doesn't lose precision, and gives _dist / _time when both limits are INFINITY.
+        Scalar k = 1 / accelLimit + 1 / decelLimit;
+        Scalar tempVelLimit = 2 * _dist / (_time + sqrt(sq(_time) - 2 * k * _dist));
         boolean possible = !isnan(tempVelLimit) && tempVelLimit <= abs(_maxVel); // nan check, speed check
         if (possible) {
             velLimit = tempVelLimit;
@@ -683,6 +1808,26 @@ public:
         return possible;
     }
 
+    /**
+     * @brief  the shortest time that setVelLimitForTimedMove() can fit a move of a distance into
+     * @param  _dist: (float) how far you want to move
+     * @param  _maxVel: (float, optional, default=NAN) maximum allowable velocity, if NAN the velocity limit set in the constructor or setVelLimit() is used
+     * @retval (float) seconds
+     */
+    Scalar getMinTimeForMove(Scalar _dist, Scalar _maxVel = NAN)
+    {
+        _dist = abs(_dist);
+        if (isnan(_maxVel))
+            _maxVel = originalVelLimit;
+        _maxVel = abs(_maxVel);
+        if (_dist == 0)
+            return 0;
+        Scalar k = 1 / accelLimit + 1 / decelLimit; // see setVelLimitForTimedMove()
+        if (_dist >= sq(_maxVel) * k / 2) // reaches _maxVel, trapezoid
+            return _dist / _maxVel + _maxVel * k / 2;
+        return sqrt(2 * _dist * k); // triangle, peak velocity sqrt(2 * _dist / k)
+    }
+
     /**
      * @brief  This function changes velLimit so that a move to the specified target position takes the specified time (if possible given acceleration limit)
      * @note   using this function changes the value of velLimit from whatever you set it to when you created the Derivs_Limiter object
@@ -691,7 +1836,7 @@ public:
      * @param  _maxVel: (float, optional, default=NAN) maximum allowable velocity, if the required velocity exceeds this the function returns false, if NAN the velocity limit set in the constructor or setVelLimit() is used
      * @retval (bool) true if move possible within time given acceleration limit, false if not possible (and nothing is changed)
      */
-    boolean setTargetAndVelLimitForTimedMove(float _target, float _time, float _maxVel = NAN)
+    boolean setTargetAndVelLimitForTimedMove(Scalar _target, Scalar _time, Scalar _maxVel = NAN)
     {
         boolean ret = setVelLimitForTimedMove(_target - position, _time, _maxVel);
         if (ret) {
@@ -709,7 +1854,7 @@ public:
      * @param  _maxVel: (float, optional, default=NAN) maximum allowable velocity, if the required velocity exceeds this the function returns false, if NAN the velocity limit set in the constructor or setVelLimit() is used
      * @retval (bool) true if move possible within time given acceleration limit, false if not possible (and move happens with maxVel instead but will not complete in time)
      */
-    boolean setTargetTimedMovePreferred(float _target, float _time, float _maxVel = NAN)
+    boolean setTargetTimedMovePreferred(Scalar _target, Scalar _time, Scalar _maxVel = NAN)
     {
         boolean ret = setVelLimitForTimedMove(_target - position, _time, _maxVel);
         if (ret) {
@@ -730,9 +1875,9 @@ public:
      * @brief  call this as frequently as possible to calculate all the values
      * @retval (float) position
      */
-    float calc()
+    Scalar calc()
     {
-        return _calc();
+        return derived()._calc();
     }
 
     /**
@@ -740,144 +1885,234 @@ public:
      * @param  _target: set the target position, ignored if NAN
      * @retval (float) position
      */
-    float calc(float _target)
+    Scalar calc(Scalar _target)
+    {
+        if (!isnan(_target)) {
+            target = _target;
+            posMode = true;
+        }
+        return derived()._calc();
+    }
+
+    /**
+     * @brief  run the calculation for a time interval that you give instead of reading the clock
+     * @note   use this when one timestamp drives many Derivs_Limiters, or for simulations that should give the same result every run. The clock isn't read, so use resetTime() before going back to calc(). Subclasses that override _calc() aren't run by step().
+     * @param  dt: (float) time in seconds since the last calculation, nothing changes if dt isn't greater than 0
+     * @retval (float) position
+     */
+    Scalar step(Scalar dt)
+    {
+        return _step(dt);
+    }
+
+    /**
+     * @brief  run the calculation for a time interval that you give instead of reading the clock, see step()
+     * @param  _target: set the target position, ignored if NAN
+     * @param  dt: (float) time in seconds since the last calculation, nothing changes if dt isn't greater than 0
+     * @retval (float) position
+     */
+    Scalar calc(Scalar _target, Scalar dt)
     {
         if (!isnan(_target)) {
             target = _target;
             posMode = true;
         }
-        return _calc();
+        return _step(dt);
+    }
+
+    /**
+     * @brief  run step(dt) n times and write down position and velocity after each step, for example to fill a buffer that's played back by DMA
+     * @note   continues from the current state and leaves the Derivs_Limiter at the last sample, so a long motion can be made in chunks. Nothing is allocated.
+     *         With stride 2, pos = buf and vel = buf + 1 fills one interleaved buffer. extras/host/GenerateMatch.cpp checks it matches step() bit for bit.
+     * @param  pos: (float*) n positions are written here (every stride values), can be NULL
+     * @param  vel: (float*) n velocities are written here (every stride values), can be NULL
+     * @param  n: (size_t) number of samples
+     * @param  dt: (float) time in seconds between samples
+     * @param  stride: (size_t) default=1, distance between samples in pos and vel
+     * @retval None
+     */
+    void generate(Scalar* pos, Scalar* vel, size_t n, Scalar dt, size_t stride = 1)
+    {
+        for (size_t i = 0; i < n; i++) {
+            _step(dt);
+            if (pos)
+                pos[i * stride] = position;
+            if (vel)
+                vel[i * stride] = velocity;
+        }
+    }
+
+    /**
+     * @brief  hook, Derived can declare its own to run code at the start of every calculation, see Derivs_Limiter_Base
+     * @param  dt: (float) seconds since the last calculation, greater than 0
+     * @retval None
+     */
+    void preStep(Scalar dt)
+    {
+        (void)dt;
+    }
+
+    /**
+     * @brief  hook, Derived can declare its own to run code at the end of every calculation, see Derivs_Limiter_Base
+     * @param  dt: (float) seconds since the last calculation, greater than 0
+     * @retval None
+     */
+    void postStep(Scalar dt)
+    {
+        (void)dt;
     }
 
 protected:
+    Derived& derived()
+    {
+        return *static_cast<Derived*>(this);
+    }
+
+    /**
+     * @brief  is there something for the next calculation to read: a command in the mailbox, or a pointer's variable that was changed
+     * @retval (bool)
+     */
+    bool _hasInput()
+    {
+        if (isMailboxPending()) {
+            return true;
+        }
+        if (positionPointer && !isnan(*positionPointer) && *positionPointer != position) {
+            return true;
+        }
+        return velocityPointer && !isnan(*velocityPointer) && *velocityPointer != velocity;
+    }
+
+    /**
+     * @brief  time to move a distance and stop there, starting with a speed towards it, used by getTimeToTarget()
+     * @param  dist: (float) >= 0
+     * @param  speed: (float) >= 0
+     * @retval (float) seconds
+     */
+    Scalar _timeToTarget(Scalar dist, Scalar speed)
+    {
+        if (dist == 0 && speed == 0) {
+            return 0;
+        }
+        if (decelLimit != INFINITY && sq(speed) / 2 / decelLimit >= dist) { // has to slow down now, calc() brakes harder than decelLimit if needed
+            Scalar maxDecel = decelLimit * maxStoppingDecel;
+            if (maxDecel == INFINITY || sq(speed) / 2 / maxDecel <= dist) {
+                return 2 * dist / speed;
+            }
+            // can't stop in time, goes past target then comes back
+            Scalar passSpeed = sqrt(sq(speed) - 2 * maxDecel * dist);
+            Scalar passTime = (speed - passSpeed) / maxDecel;
+            if (preventGoingWrongWay) {
+                return passTime; // the way back depends on the time interval, see getTimeToTarget()
+            }
+            return passTime + passSpeed / decelLimit + _timeToTarget(sq(passSpeed) / 2 / decelLimit, 0);
+        }
+        if (velLimit == 0 || (speed == 0 && accelLimit == 0)) {
+            return INFINITY;
+        }
+        Scalar decelTime = (decelLimit == INFINITY) ? 0 : velLimit / decelLimit;
+        Scalar decelDist = (decelLimit == INFINITY) ? 0 : sq(velLimit) / 2 / decelLimit;
+        if (speed > velLimit) { // too fast, slow down to velLimit, coast, slow down to stop
+            Scalar slowDist = (decelLimit == INFINITY) ? 0 : sq(speed) / 2 / decelLimit; // slowing to velLimit plus stopping from velLimit
+            return (speed - velLimit) / decelLimit + (dist - slowDist) / velLimit + decelTime;
+        }
+        Scalar accelDist = (accelLimit == INFINITY) ? 0 : (sq(velLimit) - sq(speed)) / 2 / accelLimit;
+        if (accelDist + decelDist <= dist) { // reaches velLimit and coasts
+            Scalar accelTime = (accelLimit == INFINITY) ? 0 : (velLimit - speed) / accelLimit;
+            return accelTime + (dist - accelDist - decelDist) / velLimit + decelTime;
+        }
+        // doesn't reach velLimit, peak speed from v^2 = u^2 + 2as for both parts
+        Scalar peak;
+        if (accelLimit == INFINITY) {
+            peak = sqrt(2 * decelLimit * dist);
+        } else if (decelLimit == INFINITY) {
+            peak = sqrt(sq(speed) + 2 * accelLimit * dist);
+        } else {
+            peak = sqrt((2 * accelLimit * decelLimit * dist + decelLimit * sq(speed)) / (accelLimit + decelLimit));
+        }
+        return ((accelLimit == INFINITY) ? 0 : (peak - speed) / accelLimit) + ((decelLimit == INFINITY) ? 0 : peak / decelLimit);
+    }
+
+    /**
+     * @brief  reads the clock once and runs _step() with the time since the last calculation
+     * @retval (float) position
+     */
+    Scalar _calc()
+    {
+        unsigned long now = Clock::now();
+        Scalar _time = (now - lastTime) / (Scalar)Derivs_Limiter_Clock_Rate<Clock>::ticksPerSecond;
+        if (lastTime == 0) {
+            _time = 0; // in case there's a delay between starting the program and the first calculation avoid jump at start
+        }
+        lastTime = now;
+        return _step(_time);
+    }
+
+    /**
+     * @brief  runs the calculation, and times it if stats are compiled in
+     * @param  _time: (float) seconds since the last calculation
+     * @retval (float) position
+     */
+    Scalar _step(Scalar _time)
+    {
+        if (!Features::stats) {
+            return _stepCalc(_time);
+        }
+        unsigned long start = Clock::now();
+        Scalar ret = _stepCalc(_time);
+        recordMicros(Clock::now() - start);
+        return ret;
+    }
+
     /**
      * @brief  this is where the actual code is
+     * @param  _time: (float) seconds since the last calculation
      * @retval (float) position
      */
-    virtual float _calc()
+    Scalar _stepCalc(Scalar _time)
     {
+        takeCommand(derived());
+
         if (positionPointer && !isnan(*positionPointer))
             position = *positionPointer;
 
         if (velocityPointer && !isnan(*velocityPointer))
             velocity = *velocityPointer;
 
-        time = (micros() - lastTime) / 1000000.0;
-        if (lastTime == 0) {
-            time = 0; // in case there's a delay between starting the program and the first calculation avoid jump at start
-            lastTime = micros();
-        }
-        if (time == 0) {
+        recordStep(_time);
+        if (!(_time > 0)) { // also catches NAN
+            time = 0;
             return position;
         }
-        lastTime = micros();
+        time = _time;
+        derived().preStep(time);
 
-        // constrain positions within limits
-        if (position > posLimitHigh) {
-            position = posLimitHigh;
-            velocity = 0;
-        } else if (position < posLimitLow) {
-            position = posLimitLow;
-            velocity = 0;
+        if (Features::posLimits) {
+            Derivs_Limiter_Kernel::constrainToPosLimits(position, velocity, target, posLimitLow, posLimitHigh);
         }
-        target = constrain(target, posLimitLow, posLimitHigh);
 
         targetDelta = target - lastTarget;
         lastTarget = target;
 
-        if (preventGoingTooFast) {
-            velocity = constrain(velocity, -velLimit, velLimit);
+        unsigned int subSteps = 1;
+        Scalar dt = time;
+        if (Features::subSteps && time > maxSubStep) {
+            subSteps = min((Scalar)ceil(time / maxSubStep), (Scalar)maxSubSteps);
+            dt = time / subSteps;
         }
-        if (posMode) {
-            if (preventGoingWrongWay && velocity != 0 && target != position && ((velocity > 0) != (target - position > 0))) { // going the wrong way
-                velocity = 0;
-            }
-
-            if (velocity == 0 && position == target) { // if stopped at the target, no calculations are needed
-                accel = 0;
-                return position;
-            }
-
-            if (velocity != 0 && target != position && (velocity > 0) == (target - position > 0)
-                && (abs(position - target) - abs(velocity * (time)) <= sq(velocity) / 2.0 / decelLimit)) {
-                // predicted to be too close next time, decel now.
-                if (abs(position - target) <= abs(velocity * time) && (abs(velocity) <= decelLimit * maxStoppingDecel * time)) { // close enough and slow enough, just stop
-                    accel = 0;
-                    velocity = 0;
-                    position = target;
-                } else { // decel
-                    accel = -sq(velocity) / 2.0 / (target - (position));
-                    accel = constrain(accel, -decelLimit * maxStoppingDecel, decelLimit * maxStoppingDecel);
-                    velocity += accel * time;
-                    position += velocity * time;
-                }
-            } else if (velocity != 0 && target != position && (velocity > 0) != (target - position > 0)) { // if going wrong way, decel
-                accel = ((target - position > 0) ? decelLimit : -decelLimit);
-                velocity += accel * time;
-                if (velocity != 0 && (velocity > 0) == (target - position > 0)) { // switched direction, stop at zero velocity, in case accel is lower
-                    velocity = 0;
-                    accel = 0;
-                } else {
-                    position += velocity * time;
-                }
-            } else if (abs(velocity) < velLimit) { // too slow, speed up
-                float tempVelocity = velocity;
-                accel = (position > target) ? -accelLimit : accelLimit;
-                velocity += accel * time;
-                velocity = constrain(velocity, -velLimit, velLimit);
-                float maxSpeedThatCanBeStopped = sqrt(2 * (decelLimit)*abs(position - target)); // v^2 = u^2 + 2as
-                velocity = constrain(velocity, -maxSpeedThatCanBeStopped, maxSpeedThatCanBeStopped);
-                accel = (velocity - tempVelocity) / time;
-                position += velocity * time;
-                if (abs(position - target) <= abs(velocity * time) && (abs(velocity) <= decelLimit * maxStoppingDecel * time)) { // close enough and slow enough, just stop
-                    accel = 0;
-                    velocity = 0;
-                    position = target;
-                }
-            } else if (abs(velocity) > velLimit) { // too fast, slow down
-                boolean velPositive = (velocity > 0);
-                float tempVelocity = velocity;
-                velocity += velPositive ? -decelLimit * time : decelLimit * time;
-                if (velPositive) {
-                    if (velocity < velLimit) {
-                        velocity = velLimit;
-                    }
-                } else { // vel negative
-                    if (velocity > -velLimit) {
-                        velocity = -velLimit;
-                    }
-                }
-
-                accel = (velocity - tempVelocity) / time;
-                position += velocity * time;
-            } else { // coast, no accel
-                accel = 0;
-                position += velocity * time;
-            }
-        } else { // not pos mode, vel mode
-            float tempVelocity = velocity;
-            velocityTarget = constrain(velocityTarget, -velLimit, velLimit);
-            if (preventGoingWrongWay && velocity != 0 && velocityTarget != 0 && (velocity > 0) != (velocityTarget > 0)) {
-                velocity = 0;
+        for (unsigned int i = 0; i < subSteps; i++) {
+            if (i > 0 && Features::posLimits) { // position can reach a limit partway through
+                Derivs_Limiter_Kernel::constrainToPosLimits(position, velocity, target, posLimitLow, posLimitHigh);
             }
-            if (velocity != velocityTarget) {
-                if (velocity == 0) {
-                    velocity += constrain(velocityTarget - velocity, -accelLimit * time, accelLimit * time);
-                } else if (velocity > 0) {
-                    velocity += constrain(velocityTarget - velocity, -decelLimit * time, accelLimit * time);
-                    if (velocity < 0) { // prevent decel from crossing zero and causing accel
-                        velocity = 0;
-                    }
-                } else { // velocity < 0
-                    velocity += constrain(velocityTarget - velocity, -accelLimit * time, decelLimit * time);
-                    if (velocity > 0) { // prevent decel from crossing zero and causing accel
-                        velocity = 0;
-                    }
+            if (!_advance(dt)) { // if stopped at the target, no calculations are needed
+                if (i == 0) {
+                    derived().postStep(time);
+                    return position;
                 }
+                break;
             }
-            accel = (velocity - tempVelocity) / time;
-            position += velocity * time;
         }
+        derived().postStep(time);
 
         if (positionPointer)
             *positionPointer = position;
@@ -889,5 +2124,66 @@ protected:
 
         return position;
     }
+
+    /**
+     * @brief  move position and velocity forward by one (sub-)step
+     * @param  dt: (Scalar) seconds, greater than 0
+     * @retval (bool) false if it was stopped at the target, and nothing changed
+     */
+    bool _advance(Scalar dt)
+    {
+        if (preventGoingTooFast) {
+            velocity = constrain(velocity, -velLimit, velLimit);
+        }
+        if (posMode) {
+            if (Features::jerk && jerkLimit != INFINITY) {
+                Derivs_Limiter_Kernel::Regime regime = Derivs_Limiter_Kernel::posModeJerk(position, velocity, accel, target, velLimit, accelLimit, decelLimit, maxStoppingDecel, jerkLimit, preventGoingWrongWay, dt);
+                recordRegime(regime);
+                return regime != Derivs_Limiter_Kernel::AT_TARGET;
+            } else if (stepProfile(position, velocity, accel, target, velLimit, accelLimit, decelLimit, dt)) {
+                recordProfileStep();
+                return true;
+            } else {
+                Derivs_Limiter_Kernel::Regime regime = Derivs_Limiter_Kernel::posMode(position, velocity, accel, target, velLimit, accelLimit, decelLimit, maxStoppingDecel, preventGoingWrongWay, dt);
+                recordRegime(regime);
+                return regime != Derivs_Limiter_Kernel::AT_TARGET;
+            }
+        } else if (Features::jerk && jerkLimit != INFINITY) { // vel mode
+            recordRegime(Derivs_Limiter_Kernel::velModeJerk(position, velocity, accel, velocityTarget, velLimit, accelLimit, decelLimit, jerkLimit, preventGoingWrongWay, dt));
+        } else { // not pos mode, vel mode
+            recordRegime(Derivs_Limiter_Kernel::velMode(position, velocity, accel, velocityTarget, velLimit, accelLimit, decelLimit, preventGoingWrongWay, dt));
+        }
+        return true;
+    }
 };
+
+/**
+ * @brief  This library can be used to limit the first and second derivative of a variable as it approaches a target value.
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   Derivs_Limiter is this class with float values and the default clock. Use Derivs_Limiter_T<double> for more precision (for example for an axis that turns continuously), and Derivs_Limiter_T<float, YourClock> to read time from somewhere other than micros(). Values documented as (float) are Scalar.
+ * @tparam Scalar: type used for every value, float or double
+ * @tparam Clock: type with a static unsigned long now() function that returns microseconds (or another unit, see Derivs_Limiter_Clock_Rate)
+ * @tparam Features: Derivs_Limiter_Features, which optional features are compiled in, default all of them
+ * @note   _calc() is virtual so subclasses can override it. To extend it without a virtual call, derive from Derivs_Limiter_Base instead.
+ */
+template <typename Scalar = float, typename Clock = Derivs_Limiter_Micros_Clock, typename Features = Derivs_Limiter_All_Features>
+class Derivs_Limiter_T : public Derivs_Limiter_Base<Derivs_Limiter_T<Scalar, Clock, Features>, Scalar, Clock, Features> {
+    typedef Derivs_Limiter_Base<Derivs_Limiter_T<Scalar, Clock, Features>, Scalar, Clock, Features> Base;
+    friend Base;
+
+public:
+    using Base::Base; // same constructors as Derivs_Limiter_Base
+
+protected:
+    /**
+     * @brief  reads the clock once and runs _step() with the time since the last calculation, override to change what calc() does
+     * @retval (float) position
+     */
+    virtual Scalar _calc()
+    {
+        return Base::_calc();
+    }
+};
+
+typedef Derivs_Limiter_T<> Derivs_Limiter;
 #endif
@@ -0,0 +1,447 @@
+#ifndef _DERIVS_LIMITER_BANK_H_
+#define _DERIVS_LIMITER_BANK_H_
+#include "Derivs_Limiter.h"
+#include "Derivs_Limiter_SIMD.h"
+/**
+ * @brief  N channels that each act like an independent Derivs_Limiter, stored as one array per value and calculated together with one time interval
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   Each channel gives the same results as a Derivs_Limiter with the same settings that is run with step() or calc(target, dt) using the same time intervals.
+ *         Channels don't have position or velocity pointers, timed moves, or the target and position delta values.
+ *         Use getPositions() to get all the positions as one array, for example to send them to LEDs or servos.
+ *         Where SIMD instructions are available (see Derivs_Limiter_SIMD.h), groups of channels that are all in position mode are calculated together.
+ * @tparam N: number of channels
+ * @tparam Clock: clock policy used by calc(), see Derivs_Limiter_Micros_Clock
+ */
+template <size_t N, typename Clock = Derivs_Limiter_Micros_Clock>
+class Derivs_Limiter_Bank {
+protected:
+    float position[N];
+    float velocity[N];
+    float accel[N];
+    float target[N];
+    float velocityTarget[N];
+    float velLimit[N];
+    float accelLimit[N];
+    float decelLimit[N];
+    float maxStoppingDecel[N];
+    float posLimitLow[N];
+    float posLimitHigh[N];
+    bool preventGoingWrongWay[N];
+    bool preventGoingTooFast[N];
+    bool posMode[N];
+    unsigned long lastTime;
+    float time;
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Bank, every channel starts with the same limits, stopped at 0, and with the other settings at the Derivs_Limiter constructor's defaults
+     * @param  _velLimit: (float) default=0, velocity limit (units per second)
+     * @param  _accelLimit: (float) default=0, acceleration limit (units per second per second)
+     * @param  _decelLimit: (float) default=NAN, deceleration limit (units per second per second), set to NAN to use accelLimit
+     */
+    Derivs_Limiter_Bank(float _velLimit = 0, float _accelLimit = 0, float _decelLimit = NAN)
+    {
+        lastTime = 0;
+        time = 0;
+        for (size_t i = 0; i < N; i++) {
+            position[i] = 0;
+            velocity[i] = 0;
+            accel[i] = 0;
+            target[i] = 0;
+            velocityTarget[i] = 0;
+            maxStoppingDecel[i] = 2;
+            posLimitLow[i] = -INFINITY;
+            posLimitHigh[i] = INFINITY;
+            preventGoingWrongWay[i] = false;
+            preventGoingTooFast[i] = false;
+            posMode[i] = true;
+            setVelAccelLimits(i, _velLimit, _accelLimit, _decelLimit);
+        }
+    }
+
+    /**
+     * @brief  number of channels
+     * @retval (size_t)
+     */
+    size_t size() const
+    {
+        return N;
+    }
+
+    /**
+     * @brief  copy the state and settings of a Derivs_Limiter into a channel
+     * @note   position and velocity pointers are not copied
+     * @param  i: (size_t) channel
+     * @param  limiter: Derivs_Limiter to copy from
+     * @retval None
+     */
+    template <typename D, typename S, typename C, typename F>
+    void copyFrom(size_t i, Derivs_Limiter_Base<D, S, C, F>& limiter)
+    {
+        position[i] = limiter.getPosition();
+        velocity[i] = limiter.getVelocity();
+        accel[i] = limiter.getAcceleration();
+        target[i] = limiter.getTarget();
+        velocityTarget[i] = limiter.getVelTarget();
+        velLimit[i] = limiter.getVelLimit();
+        accelLimit[i] = limiter.getAccelLimit();
+        decelLimit[i] = limiter.getDecelLimit();
+        maxStoppingDecel[i] = limiter.getMaxStoppingDecel();
+        posLimitLow[i] = limiter.getLowPosLimit();
+        posLimitHigh[i] = limiter.getHighPosLimit();
+        preventGoingWrongWay[i] = limiter.getPreventGoingWrongWay();
+        preventGoingTooFast[i] = limiter.getPreventGoingTooFast();
+        posMode[i] = limiter.isPosModeNotVelocity();
+    }
+
+    /**
+     * @brief  set target position of a channel (doesn't run calculation)
+     * @param  i: (size_t) channel
+     * @param  _target: (float) position, ignored if NAN
+     * @retval (bool) position==target
+     */
+    bool setTarget(size_t i, float _target)
+    {
+        if (!isnan(_target)) {
+            target[i] = _target;
+            posMode[i] = true;
+        }
+        return position[i] == target[i];
+    }
+
+    /**
+     * @brief  set position of a channel
+     * @param  i: (size_t) channel
+     * @param  pos: (float) ignored if NAN
+     * @retval None
+     */
+    void setPosition(size_t i, float pos)
+    {
+        if (!isnan(pos))
+            position[i] = pos;
+    }
+
+    /**
+     * @brief  set velocity of a channel
+     * @param  i: (size_t) channel
+     * @param  vel: (float) ignored if NAN
+     * @retval None
+     */
+    void setVelocity(size_t i, float vel)
+    {
+        if (!isnan(vel))
+            velocity[i] = vel;
+    }
+
+    /**
+     * @brief  set position and target of a channel to a value
+     * @param  i: (size_t) channel
+     * @param  targPos: (float)
+     * @retval None
+     */
+    void setPositionAndTarget(size_t i, float targPos)
+    {
+        setPosition(i, targPos);
+        setTarget(i, targPos);
+    }
+
+    /**
+     * @brief  set velocity, acceleration and deceleration limits of a channel
+     * @param  i: (size_t) channel
+     * @param  velLim: (float) velocity limit
+     * @param  accLim: (float) acceleration limit
+     * @param  decLim: (float) deceleration limit, set NAN to set equal to acceleration limit
+     * @retval None
+     */
+    void setVelAccelLimits(size_t i, float velLim, float accLim, float decLim = NAN)
+    {
+        velLimit[i] = abs(velLim);
+        accelLimit[i] = abs(accLim);
+        decelLimit[i] = isnan(decLim) ? accelLimit[i] : abs(decLim);
+    }
+
+    /**
+     * @brief  set the boundaries for position of a channel
+     * @note   ignored unless lowLimit < highLimit, like Derivs_Limiter
+     * @param  i: (size_t) channel
+     * @param  lowLimit: (float), -INFINITY means no limit
+     * @param  highLimit: (float), INFINITY means no limit
+     * @retval None
+     */
+    void setPosLimits(size_t i, float lowLimit, float highLimit)
+    {
+        if (lowLimit < highLimit) {
+            posLimitLow[i] = lowLimit;
+            posLimitHigh[i] = highLimit;
+        }
+    }
+
+    /**
+     * @brief  set how many times decelLimit a channel can use to stop in time for target position
+     * @param  i: (size_t) channel
+     * @param  _maxStoppingDecel: (float) must be >=1.0, can be INFINITY
+     * @retval None
+     */
+    void setMaxStoppingDecel(size_t i, float _maxStoppingDecel)
+    {
+        maxStoppingDecel[i] = max(_maxStoppingDecel, (float)1.0);
+    }
+
+    /**
+     * @brief  see Derivs_Limiter::setPreventGoingWrongWay()
+     * @param  i: (size_t) channel
+     * @param  _preventGoingWrongWay: (bool)
+     * @retval None
+     */
+    void setPreventGoingWrongWay(size_t i, bool _preventGoingWrongWay)
+    {
+        preventGoingWrongWay[i] = _preventGoingWrongWay;
+    }
+
+    /**
+     * @brief  see Derivs_Limiter::setPreventGoingTooFast()
+     * @param  i: (size_t) channel
+     * @param  _preventGoingTooFast: (bool)
+     * @retval None
+     */
+    void setPreventGoingTooFast(size_t i, bool _preventGoingTooFast)
+    {
+        preventGoingTooFast[i] = _preventGoingTooFast;
+    }
+
+    /**
+     * @brief  switch a channel to velocity mode, and set velocity immediately to a constant value
+     * @param  i: (size_t) channel
+     * @param  vel: (float) ignored if NAN
+     * @retval None
+     */
+    void setVelConstant(size_t i, float vel)
+    {
+        if (isnan(vel)) {
+            return;
+        }
+        posMode[i] = false;
+        velocity[i] = vel;
+        velocityTarget[i] = vel;
+    }
+
+    /**
+     * @brief  switch a channel to velocity mode, and set a target velocity that it goes towards limited by accelLimit
+     * @param  i: (size_t) channel
+     * @param  vel: (float) ignored if NAN
+     * @retval None
+     */
+    void setVelTarget(size_t i, float vel)
+    {
+        if (isnan(vel)) {
+            return;
+        }
+        posMode[i] = false;
+        velocityTarget[i] = vel;
+    }
+
+    /**
+     * @brief  get the current position of a channel, but doesn't calculate anything
+     * @param  i: (size_t) channel
+     * @retval (float)
+     */
+    float getPosition(size_t i) const
+    {
+        return position[i];
+    }
+
+    /**
+     * @brief  get the current velocity of a channel
+     * @param  i: (size_t) channel
+     * @retval (float) (units per second)
+     */
+    float getVelocity(size_t i) const
+    {
+        return velocity[i];
+    }
+
+    /**
+     * @brief  get the current acceleration of a channel
+     * @note   for debugging only, value noisy
+     * @param  i: (size_t) channel
+     * @retval (float) (units per second per second)
+     */
+    float getAcceleration(size_t i) const
+    {
+        return accel[i];
+    }
+
+    /**
+     * @brief  get target position of a channel
+     * @param  i: (size_t) channel
+     * @retval (float)
+     */
+    float getTarget(size_t i) const
+    {
+        return target[i];
+    }
+
+    /**
+     * @brief  does position of a channel equal its target?
+     * @param  i: (size_t) channel
+     * @retval (bool)
+     */
+    bool isPosAtTarget(size_t i) const
+    {
+        return position[i] == target[i];
+    }
+
+    /**
+     * @brief  positions of all channels
+     * @retval (const float*) array of N positions
+     */
+    const float* getPositions() const
+    {
+        return position;
+    }
+
+    /**
+     * @brief  velocities of all channels
+     * @retval (const float*) array of N velocities
+     */
+    const float* getVelocities() const
+    {
+        return velocity;
+    }
+
+    /**
+     * @brief  If calc hasn't been run for a while, use this before starting to use it again to protect from large jumps.
+     * @retval None
+     */
+    void resetTime()
+    {
+        lastTime = Clock::now();
+    }
+
+    /**
+     * @brief  returns the time (in seconds) between the two most recent calculation times
+     * @retval (float)
+     */
+    float getTimeInterval() const
+    {
+        return time;
+    }
+
+    /**
+     * @brief  reads the clock once and calculates every channel
+     * @retval None
+     */
+    void calc()
+    {
+        unsigned long now = Clock::now();
+        float _time = (now - lastTime) / (float)Derivs_Limiter_Clock_Rate<Clock>::ticksPerSecond;
+        if (lastTime == 0) {
+            _time = 0; // in case there's a delay between starting the program and the first calculation avoid jump at start
+        }
+        lastTime = now;
+        step(_time);
+    }
+
+    /**
+     * @brief  calculates every channel for a time interval that you give instead of reading the clock
+     * @param  dt: (float) time in seconds since the last calculation, nothing changes if dt isn't greater than 0
+     * @retval None
+     */
+    void step(float dt)
+    {
+        if (!(dt > 0)) { // also catches NAN
+            time = 0;
+            return;
+        }
+        time = dt;
+        stepRange(0, N, dt);
+    }
+
+    /**
+     * @brief  calculates some of the channels for a time interval, the others aren't changed
+     * @note   the channels give the same results as with step(dt), so different ranges can be calculated by different threads (see Derivs_Limiter_Parallel).
+     *         getTimeInterval() isn't changed.
+     * @param  first: (size_t) first channel
+     * @param  count: (size_t) number of channels, stops at the end of the bank
+     * @param  dt: (float) time in seconds since the last calculation, nothing changes if dt isn't greater than 0
+     * @retval None
+     */
+    void stepRange(size_t first, size_t count, float dt)
+    {
+        if (!(dt > 0) || first >= N) {
+            return;
+        }
+        size_t end = (count > N - first) ? N : first + count;
+        size_t i = first;
+#ifdef DERIVS_LIMITER_SIMD
+        const size_t width = Derivs_Limiter_SIMD::width;
+        for (; i < end && i % width != 0; i++) { // vectors start at the same channels as in step()
+            stepChannel(i, dt);
+        }
+        for (; i + width <= end; i += width) {
+            bool allPosMode = true;
+            for (size_t j = i; j < i + width; j++) {
+                allPosMode = allPosMode && posMode[j];
+            }
+            if (allPosMode) {
+                stepVector(i, dt);
+            } else {
+                for (size_t j = i; j < i + width; j++) {
+                    stepChannel(j, dt);
+                }
+            }
+        }
+#endif
+        for (; i < end; i++) {
+            stepChannel(i, dt);
+        }
+    }
+
+protected:
+    /**
+     * @brief  calculates one channel
+     * @param  i: (size_t) channel
+     * @param  dt: (float) seconds, greater than 0
+     * @retval None
+     */
+    void stepChannel(size_t i, float dt)
+    {
+        Derivs_Limiter_Kernel::constrainToPosLimits(position[i], velocity[i], target[i], posLimitLow[i], posLimitHigh[i]);
+        if (preventGoingTooFast[i]) {
+            velocity[i] = constrain(velocity[i], -velLimit[i], velLimit[i]);
+        }
+        if (posMode[i]) {
+            Derivs_Limiter_Kernel::posMode(position[i], velocity[i], accel[i], target[i], velLimit[i], accelLimit[i], decelLimit[i], maxStoppingDecel[i], preventGoingWrongWay[i], dt);
+        } else {
+            Derivs_Limiter_Kernel::velMode(position[i], velocity[i], accel[i], velocityTarget[i], velLimit[i], accelLimit[i], decelLimit[i], preventGoingWrongWay[i], dt);
+        }
+    }
+
+#ifdef DERIVS_LIMITER_SIMD
+    /**
+     * @brief  calculates Derivs_Limiter_SIMD::width channels that are all in position mode
+     * @param  i: (size_t) first channel
+     * @param  dt: (float) seconds, greater than 0
+     * @retval None
+     */
+    void stepVector(size_t i, float dt)
+    {
+        typedef Derivs_Limiter_SIMD V;
+        typedef Derivs_Limiter_Vector_Kernel<V> K;
+        V::F pos = V::load(position + i);
+        V::F vel = V::load(velocity + i);
+        V::F acc;
+        V::F targ = V::load(target + i);
+        V::F velLim = V::load(velLimit + i);
+        K::constrainToPosLimits(pos, vel, targ, V::load(posLimitLow + i), V::load(posLimitHigh + i));
+        vel = V::select(V::fromBools(preventGoingTooFast + i), K::constrainV(vel, V::neg(velLim), velLim), vel);
+        K::posMode(pos, vel, acc, targ, velLim, V::load(accelLimit + i), V::load(decelLimit + i), V::load(maxStoppingDecel + i),
+            V::fromBools(preventGoingWrongWay + i), V::set1(dt));
+        V::store(position + i, pos);
+        V::store(velocity + i, vel);
+        V::store(accel + i, acc);
+        V::store(target + i, targ);
+    }
+#endif
+};
+#endif
@@ -0,0 +1,255 @@
+#ifndef _DERIVS_LIMITER_COMPACT_H_
+#define _DERIVS_LIMITER_COMPACT_H_
+#include "Derivs_Limiter.h"
+
+/**
+ * @brief  limits and settings that many Derivs_Limiter_Compacts can share, each one only stores a pointer to it
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   the values can be changed directly at any time and every Derivs_Limiter_Compact using them sees the change at its next step.
+ *         Limits must not be negative or NAN (the constructor fixes this for its arguments), and posLimitHigh must not be below posLimitLow.
+ * @tparam Scalar: float or double
+ */
+template <typename Scalar = float>
+struct Derivs_Limiter_Shared_Limits_T {
+    Scalar velLimit;
+    Scalar accelLimit;
+    Scalar decelLimit;
+    Scalar maxStoppingDecel;
+    Scalar posLimitLow;
+    Scalar posLimitHigh;
+    bool preventGoingWrongWay;
+    bool preventGoingTooFast;
+
+    /**
+     * @brief  constructor for Derivs_Limiter_Shared_Limits, the arguments mean the same as in the Derivs_Limiter constructor
+     * @param  _velLimit: (float) default=0
+     * @param  _accelLimit: (float) default=0
+     * @param  _decelLimit: (float) default=NAN, set to NAN to use accelLimit
+     * @param  _preventGoingWrongWay: (bool) default=false
+     * @param  _preventGoingTooFast: (bool) default=false
+     * @param  _posLimitLow: (float) default=-INFINITY
+     * @param  _posLimitHigh: (float) default=INFINITY
+     * @param  _maxStoppingDecel: (float) default=2
+     */
+    Derivs_Limiter_Shared_Limits_T(Scalar _velLimit = 0, Scalar _accelLimit = 0, Scalar _decelLimit = NAN, bool _preventGoingWrongWay = false, bool _preventGoingTooFast = false,
+        Scalar _posLimitLow = -INFINITY, Scalar _posLimitHigh = INFINITY, Scalar _maxStoppingDecel = 2)
+    {
+        velLimit = abs(_velLimit);
+        accelLimit = abs(_accelLimit);
+        decelLimit = isnan(_decelLimit) ? accelLimit : abs(_decelLimit);
+        maxStoppingDecel = max(_maxStoppingDecel, (Scalar)1.0);
+        posLimitLow = _posLimitLow;
+        posLimitHigh = max(_posLimitHigh, _posLimitLow);
+        preventGoingWrongWay = _preventGoingWrongWay;
+        preventGoingTooFast = _preventGoingTooFast;
+    }
+};
+
+/**
+ * @brief  a Derivs_Limiter that only stores position, velocity, target, and a pointer to limits it can share with others, for when memory is short (like on an Arduino Uno)
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   It gives the same position and velocity as a Derivs_Limiter with the same settings run with step() using the same time intervals.
+ *         To stay small it doesn't read a clock (use step(dt), with dt measured once for all channels), and has no acceleration output, pointers, timed moves, jerk limit, profile, mailbox,
+ *         or the target and position delta values. Its size is checked by a static_assert below this class: 3 Scalars and a pointer, plus padding.
+ * @tparam Scalar: float or double
+ */
+template <typename Scalar = float>
+class Derivs_Limiter_Compact_T {
+protected:
+    const Derivs_Limiter_Shared_Limits_T<Scalar>* limits; // first, so there's no padding between it and the Scalars
+    Scalar position;
+    Scalar velocity;
+    Scalar target; // velocity target in velocity mode
+    bool posMode;
+
+public:
+    typedef Scalar ScalarType; // for classes that take the limiter type as a template parameter, like Derivs_Limiter_Dirty_List
+
+    /**
+     * @brief  constructor for Derivs_Limiter_Compact
+     * @param  _limits: (Derivs_Limiter_Shared_Limits*) default=NULL, use &limits, nothing moves while this is NULL
+     * @param  _startPos: (float) default=0, position and target
+     */
+    Derivs_Limiter_Compact_T(const Derivs_Limiter_Shared_Limits_T<Scalar>* _limits = NULL, Scalar _startPos = 0)
+    {
+        limits = _limits;
+        position = isnan(_startPos) ? 0 : _startPos;
+        velocity = 0;
+        target = position;
+        posMode = true;
+    }
+
+    /**
+     * @brief  set which limits to use
+     * @param  _limits: (Derivs_Limiter_Shared_Limits*) use &limits, nothing moves while this is NULL
+     * @retval None
+     */
+    void setLimits(const Derivs_Limiter_Shared_Limits_T<Scalar>* _limits)
+    {
+        limits = _limits;
+    }
+
+    /**
+     * @brief  get the limits that are used
+     * @retval (const Derivs_Limiter_Shared_Limits*)
+     */
+    const Derivs_Limiter_Shared_Limits_T<Scalar>* getLimits()
+    {
+        return limits;
+    }
+
+    /**
+     * @brief  set target position, switches to position mode
+     * @param  _target: (float) ignored if NAN
+     * @retval (bool) position==target
+     */
+    bool setTarget(Scalar _target)
+    {
+        if (!isnan(_target)) {
+            target = _target;
+            posMode = true;
+        }
+        return posMode && position == target;
+    }
+
+    /**
+     * @brief  get target position
+     * @retval (float) NAN in velocity mode
+     */
+    Scalar getTarget()
+    {
+        return posMode ? target : NAN;
+    }
+
+    /**
+     * @brief  velocity approaches the set target with limited accel and decel, switches to velocity mode
+     * @param  vel: (float) ignored if NAN
+     * @retval None
+     */
+    void setVelTarget(Scalar vel)
+    {
+        if (isnan(vel)) {
+            return;
+        }
+        target = vel;
+        posMode = false;
+    }
+
+    /**
+     * @brief  get velocity target
+     * @retval (float) NAN in position mode
+     */
+    Scalar getVelTarget()
+    {
+        return posMode ? NAN : target;
+    }
+
+    /**
+     * @brief  is it in position mode (true) or velocity mode (false)
+     * @retval (bool)
+     */
+    bool isPosModeNotVelocity()
+    {
+        return posMode;
+    }
+
+    /**
+     * @brief  set position
+     * @param  pos: (float) ignored if NAN
+     * @retval None
+     */
+    void setPosition(Scalar pos)
+    {
+        if (!isnan(pos))
+            position = pos;
+    }
+
+    /**
+     * @brief  set velocity
+     * @param  vel: (float) ignored if NAN
+     * @retval None
+     */
+    void setVelocity(Scalar vel)
+    {
+        if (!isnan(vel))
+            velocity = vel;
+    }
+
+    /**
+     * @brief  set position and target to the same value and stop, switches to position mode
+     * @param  targPos: (float) ignored if NAN
+     * @retval None
+     */
+    void setPositionAndTarget(Scalar targPos)
+    {
+        if (isnan(targPos))
+            return;
+        position = targPos;
+        target = targPos;
+        velocity = 0;
+        posMode = true;
+    }
+
+    /**
+     * @brief  get position
+     * @retval (float)
+     */
+    Scalar getPosition()
+    {
+        return position;
+    }
+
+    /**
+     * @brief  get velocity
+     * @retval (float)
+     */
+    Scalar getVelocity()
+    {
+        return velocity;
+    }
+
+    /**
+     * @brief  is position equal to target (and in position mode)
+     * @retval (bool)
+     */
+    bool isPosAtTarget()
+    {
+        return posMode && position == target;
+    }
+
+    /**
+     * @brief  calculate for a time interval
+     * @param  dt: (float) time in seconds since the last calculation, nothing changes if dt isn't greater than 0 or there are no limits
+     * @retval (float) position
+     */
+    Scalar step(Scalar dt)
+    {
+        if (!(dt > 0) || !limits) { // also catches NAN
+            return position;
+        }
+        const Derivs_Limiter_Shared_Limits_T<Scalar>& l = *limits;
+        Scalar accel = 0;
+        if (posMode) {
+            Derivs_Limiter_Kernel::constrainToPosLimits(position, velocity, target, l.posLimitLow, l.posLimitHigh);
+        } else {
+            Scalar ignoredTarget = position;
+            Derivs_Limiter_Kernel::constrainToPosLimits(position, velocity, ignoredTarget, l.posLimitLow, l.posLimitHigh);
+        }
+        if (l.preventGoingTooFast) {
+            velocity = constrain(velocity, -l.velLimit, l.velLimit);
+        }
+        if (posMode) {
+            Derivs_Limiter_Kernel::posMode(position, velocity, accel, target, l.velLimit, l.accelLimit, l.decelLimit, l.maxStoppingDecel, l.preventGoingWrongWay, dt);
+        } else {
+            Derivs_Limiter_Kernel::velMode(position, velocity, accel, target, l.velLimit, l.accelLimit, l.decelLimit, l.preventGoingWrongWay, dt);
+        }
+        return position;
+    }
+};
+
+static_assert(sizeof(Derivs_Limiter_Compact_T<float>) <= 3 * sizeof(float) + 2 * sizeof(void*), "Derivs_Limiter_Compact should be 3 floats, a pointer, and a bool");
+static_assert(sizeof(Derivs_Limiter_Compact_T<double>) <= 3 * sizeof(double) + 2 * sizeof(void*), "Derivs_Limiter_Compact_T<double> should be 3 doubles, a pointer, and a bool");
+
+typedef Derivs_Limiter_Shared_Limits_T<float> Derivs_Limiter_Shared_Limits;
+typedef Derivs_Limiter_Compact_T<float> Derivs_Limiter_Compact;
+#endif
@@ -0,0 +1,254 @@
+#ifndef _DERIVS_LIMITER_DIRTY_LIST_H_
+#define _DERIVS_LIMITER_DIRTY_LIST_H_
+#include "Derivs_Limiter_Pointer_Array.h"
+
+/**
+ * @brief  rounds a position to the resolution of the output it drives, and remembers the value that was last sent to the output
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   kept outside the limiter so only the channels that need it pay for it, Derivs_Limiter_Dirty_List has one per channel
+ * @tparam Scalar: float or double
+ */
+template <typename Scalar = float>
+class Derivs_Limiter_Quantizer_T {
+protected:
+    Scalar step;
+    Scalar offset;
+    Scalar taken;
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Quantizer
+     * @param  _step: (float) default=0, outputs are offset plus a whole number of steps (like 1 microsecond of servo pulse, or one count of a PWM chip), 0 means no rounding
+     * @param  _offset: (float) default=0
+     */
+    Derivs_Limiter_Quantizer_T(Scalar _step = 0, Scalar _offset = 0)
+    {
+        step = 0;
+        offset = 0;
+        setQuantization(_step, _offset);
+        taken = NAN;
+    }
+
+    /**
+     * @brief  set the resolution of the output
+     * @param  _step: (float) outputs are offset plus a whole number of steps, 0 for no rounding, ignored if NAN
+     * @param  _offset: (float) default=0, ignored if NAN
+     * @retval None
+     */
+    void setQuantization(Scalar _step, Scalar _offset = 0)
+    {
+        if (!isnan(_step))
+            step = abs(_step);
+        if (!isnan(_offset))
+            offset = _offset;
+    }
+
+    /**
+     * @brief  get the quantization step setting
+     * @retval (float)
+     */
+    Scalar getStep()
+    {
+        return step;
+    }
+
+    /**
+     * @brief  get the quantization offset setting
+     * @retval (float)
+     */
+    Scalar getOffset()
+    {
+        return offset;
+    }
+
+    /**
+     * @brief  a position rounded to the nearest output value
+     * @param  position: (float)
+     * @retval (float) position if the step is 0
+     */
+    Scalar quantize(Scalar position)
+    {
+        if (step == 0) {
+            return position;
+        }
+        return offset + floor((position - offset) / step + (Scalar)0.5) * step;
+    }
+
+    /**
+     * @brief  is the quantized position different from what take() last returned? (true before the first take())
+     * @note   use to only write to an output (like a servo on a slow bus) when the value it receives would change
+     * @param  position: (float)
+     * @retval (bool)
+     */
+    bool isChanged(Scalar position)
+    {
+        return quantize(position) != taken;
+    }
+
+    /**
+     * @brief  quantize(position), and remember it as the value that was sent, for isChanged()
+     * @param  position: (float)
+     * @retval (float)
+     */
+    Scalar take(Scalar position)
+    {
+        taken = quantize(position);
+        return taken;
+    }
+
+    /**
+     * @brief  the value take() last returned
+     * @retval (float) NAN before the first take() and after forget()
+     */
+    Scalar getTaken()
+    {
+        return taken;
+    }
+
+    /**
+     * @brief  make isChanged() true, to send the value again (like after the output device was reset)
+     * @retval None
+     */
+    void forget()
+    {
+        taken = NAN;
+    }
+};
+typedef Derivs_Limiter_Quantizer_T<float> Derivs_Limiter_Quantizer;
+
+/**
+ * @brief  N limiters (channels) whose quantized positions are sent to outputs, finds which channels need to be sent again
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   Each channel's resolution is set with setQuantization() or setQuantizationAll(). After calculating, update() makes a list of the channels whose quantized position changed,
+ *         so only those are written (like servos on an I2C PWM chip, where every write takes bus time).
+ *         The list only holds pointers (see Derivs_Limiter_Pointer_Array for size(), setLimiter() and getLimiter()), the limiters stay usable on their own.
+ * @tparam N: number of channels
+ * @tparam Limiter: default=Derivs_Limiter, type of the channels, anything with getPosition() and a ScalarType typedef: any Derivs_Limiter_T, a class derived from Derivs_Limiter_Base, or Derivs_Limiter_Compact
+ */
+template <size_t N, typename Limiter = Derivs_Limiter>
+class Derivs_Limiter_Dirty_List : public Derivs_Limiter_Pointer_Array<N, Limiter> {
+protected:
+    typedef Derivs_Limiter_Pointer_Array<N, Limiter> Array;
+    typedef typename Limiter::ScalarType Scalar;
+    using Array::limiters;
+    Derivs_Limiter_Quantizer_T<Scalar> quantizers[N];
+    size_t dirty[N];
+    size_t dirtyCount;
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Dirty_List, set the channels with setLimiter()
+     */
+    Derivs_Limiter_Dirty_List()
+        : Array()
+    {
+        dirtyCount = 0;
+    }
+
+    /**
+     * @brief  constructor for Derivs_Limiter_Dirty_List
+     * @param  _limiters: array of N pointers to limiters
+     */
+    Derivs_Limiter_Dirty_List(Limiter* const* _limiters)
+        : Array(_limiters)
+    {
+        dirtyCount = 0;
+    }
+
+    /**
+     * @brief  set the resolution of a channel's output, see Derivs_Limiter_Quantizer::setQuantization()
+     * @param  i: (size_t) channel
+     * @param  step: (float) outputs are offset plus a whole number of steps, 0 (the default) for no rounding, ignored if NAN
+     * @param  offset: (float) default=0, ignored if NAN
+     * @retval None
+     */
+    void setQuantization(size_t i, Scalar step, Scalar offset = 0)
+    {
+        quantizers[i].setQuantization(step, offset);
+    }
+
+    /**
+     * @brief  set the resolution of every channel's output
+     * @param  step: (float) outputs are offset plus a whole number of steps, 0 for no rounding, ignored if NAN
+     * @param  offset: (float) default=0, ignored if NAN
+     * @retval None
+     */
+    void setQuantizationAll(Scalar step, Scalar offset = 0)
+    {
+        for (size_t i = 0; i < N; i++) {
+            quantizers[i].setQuantization(step, offset);
+        }
+    }
+
+    /**
+     * @brief  get the quantizer of a channel, to read its settings or quantize a value
+     * @param  i: (size_t) channel
+     * @retval (Derivs_Limiter_Quantizer&)
+     */
+    Derivs_Limiter_Quantizer_T<Scalar>& getQuantizer(size_t i)
+    {
+        return quantizers[i];
+    }
+
+    /**
+     * @brief  find the channels whose quantized position changed since they were last in the list, and take their new values
+     * @note   every channel is in the list the first time, and after forgetAll()
+     * @retval (size_t) number of channels in the list, the same as getDirtyCount()
+     */
+    size_t update()
+    {
+        dirtyCount = 0;
+        for (size_t i = 0; i < N; i++) {
+            if (limiters[i]) {
+                Scalar position = limiters[i]->getPosition();
+                if (quantizers[i].isChanged(position)) {
+                    quantizers[i].take(position);
+                    dirty[dirtyCount] = i;
+                    dirtyCount++;
+                }
+            }
+        }
+        return dirtyCount;
+    }
+
+    /**
+     * @brief  number of channels that changed in the last update()
+     * @retval (size_t)
+     */
+    size_t getDirtyCount()
+    {
+        return dirtyCount;
+    }
+
+    /**
+     * @brief  which channel is in the list at a position, in order of channel number
+     * @param  n: (size_t) 0 to getDirtyCount()-1
+     * @retval (size_t) channel
+     */
+    size_t getDirty(size_t n)
+    {
+        return dirty[n];
+    }
+
+    /**
+     * @brief  the quantized position of a channel when it was last in the list, the value to send
+     * @param  i: (size_t) channel
+     * @retval (float) NAN if it hasn't been in the list yet
+     */
+    Scalar getValue(size_t i)
+    {
+        return quantizers[i].getTaken();
+    }
+
+    /**
+     * @brief  put every channel in the list at the next update(), to send everything again (like after the output device was reset)
+     * @retval None
+     */
+    void forgetAll()
+    {
+        for (size_t i = 0; i < N; i++) {
+            quantizers[i].forget();
+        }
+    }
+};
+#endif
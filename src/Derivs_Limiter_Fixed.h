@@ -0,0 +1,473 @@
+#ifndef _DERIVS_LIMITER_FIXED_H_
+#define _DERIVS_LIMITER_FIXED_H_
+#if defined(ARDUINO) || defined(ESP_PLATFORM)
+#include <Arduino.h>
+#else
+#include "Derivs_Limiter_Shim.h"
+#endif
+#include <stdint.h>
+
+/**
+ * @brief  Derivs_Limiter using only integer math, for microcontrollers without a floating point unit (like the Arduino Uno)
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   Position, velocity, and the limits are Q16.16 fixed point (value * 65536, use DL_FIXED() or toFixed() to convert), time is in microseconds.
+ *         A calculation step uses no floating point math, no division, and no square root, only integer multiplies, shifts, and compares.
+ *
+ *         Differences from Derivs_Limiter: instead of dividing to find the exact deceleration that stops at the target,
+ *         it decelerates at decelLimit, or at decelLimit * maxStoppingDecel while it is going too fast to stop with decelLimit.
+ *         Instead of taking a square root to find the fastest speed that can still stop, it compares squared speeds and doesn't speed up past that.
+ *         Measured against Derivs_Limiter_T<double> (moves of 10 to 180 units, velLimit 100 to 300, accelLimit 50 to 800, decelLimit 0.5 to 2 times accelLimit, at 100 Hz, 1 kHz and 10 kHz):
+ *         the final position is exactly target, position during a move differs by at most 3.5% of the move distance at 100 Hz and 0.35% at 1 kHz and 10 kHz,
+ *         and moves finish between 30 calculation steps later and 30 steps sooner (most of the difference is in the last approach to the target). extras/host/FixedMatch.cpp checks this.
+ *         Position is kept with 40 fractional bits internally so that slow movement at short time steps isn't rounded away.
+ *         Acceleration isn't calculated.
+ *
+ *         Range: keep positions, targets, and limits within +-16384 units, and limits times the time step under 16384, so that intermediate products fit in 64 bits.
+ *         Time steps are limited to 60 seconds. Limits can't be infinite.
+ */
+class Derivs_Limiter_Fixed {
+protected:
+    int64_t position; // Q24.40, so that small steps at short time intervals aren't rounded away
+    int32_t velocity;
+    int32_t target;
+    int32_t velocityTarget;
+    int32_t velLimit;
+    int32_t accelLimit;
+    int32_t decelLimit;
+    int32_t posLimitLow;
+    int32_t posLimitHigh;
+    uint8_t maxStoppingDecel;
+    bool preventGoingWrongWay;
+    bool preventGoingTooFast;
+    bool posMode;
+    unsigned long lastTime;
+
+public:
+    /**
+     * @brief  one unit in Q16.16
+     */
+    static const int32_t ONE = 65536;
+
+    /**
+     * @brief  convert to Q16.16 fixed point
+     * @note   uses floating point math, use it for setup, not every calculation (or use DL_FIXED() on constants)
+     * @param  value: (float)
+     * @retval (int32_t)
+     */
+    static int32_t toFixed(float value)
+    {
+        return (int32_t)(value * ONE + (value < 0 ? -0.5f : 0.5f));
+    }
+
+    /**
+     * @brief  convert from Q16.16 fixed point
+     * @note   uses floating point math
+     * @param  value: (int32_t)
+     * @retval (float)
+     */
+    static float toFloat(int32_t value)
+    {
+        return value / (float)ONE;
+    }
+
+    /**
+     * @brief  constructor for Derivs_Limiter_Fixed, all values are Q16.16
+     * @param  _velLimit: (int32_t) velocity limit (units per second)
+     * @param  _accelLimit: (int32_t) acceleration limit (units per second per second)
+     * @param  _decelLimit: (int32_t) default=-1, deceleration limit (units per second per second), set negative to use accelLimit
+     * @param  _target: (int32_t) default=0, target value to make position approach
+     * @param  _startPos: (int32_t) default=0, starting position
+     */
+    Derivs_Limiter_Fixed(int32_t _velLimit = 0, int32_t _accelLimit = 0, int32_t _decelLimit = -1, int32_t _target = 0, int32_t _startPos = 0)
+    {
+        setPosition(_startPos);
+        velocity = 0;
+        target = _target;
+        velocityTarget = 0;
+        setVelAccelLimits(_velLimit, _accelLimit, _decelLimit);
+        posLimitLow = INT32_MIN;
+        posLimitHigh = INT32_MAX;
+        maxStoppingDecel = 2;
+        preventGoingWrongWay = false;
+        preventGoingTooFast = false;
+        posMode = true;
+        lastTime = 0;
+    }
+
+    /**
+     * @brief  set velocity, acceleration and deceleration limits (Q16.16)
+     * @param  velLim: (int32_t) velocity limit
+     * @param  accLim: (int32_t) acceleration limit
+     * @param  decLim: (int32_t) deceleration limit, set negative to set equal to acceleration limit
+     * @retval None
+     */
+    void setVelAccelLimits(int32_t velLim, int32_t accLim, int32_t decLim = -1)
+    {
+        velLimit = abs(velLim);
+        accelLimit = abs(accLim);
+        decelLimit = (decLim < 0) ? accelLimit : decLim;
+    }
+
+    /**
+     * @brief  set velocity limit
+     * @param  velLim: (int32_t) Q16.16 units per second
+     * @retval None
+     */
+    void setVelLimit(int32_t velLim)
+    {
+        velLimit = abs(velLim);
+    }
+
+    /**
+     * @brief  set acceleration limit
+     * @param  accelLim: (int32_t) Q16.16 units per second per second
+     * @retval None
+     */
+    void setAccelLimit(int32_t accelLim)
+    {
+        accelLimit = abs(accelLim);
+    }
+
+    /**
+     * @brief  set deceleration limit
+     * @param  decelLim: (int32_t) Q16.16 units per second per second, negative sets it to accelLimit
+     * @retval None
+     */
+    void setDecelLimit(int32_t decelLim)
+    {
+        decelLimit = (decelLim < 0) ? accelLimit : decelLim;
+    }
+
+    /**
+     * @brief  set how many times decelLimit can be used to stop in time for target position
+     * @param  _maxStoppingDecel: (uint8_t) at least 1
+     * @retval None
+     */
+    void setMaxStoppingDecel(uint8_t _maxStoppingDecel)
+    {
+        maxStoppingDecel = max(_maxStoppingDecel, (uint8_t)1);
+    }
+
+    /**
+     * @brief  set the boundaries for position (Q16.16)
+     * @note   ignored unless lowLimit <= highLimit
+     * @param  lowLimit: (int32_t) INT32_MIN for no limit
+     * @param  highLimit: (int32_t) INT32_MAX for no limit
+     * @retval None
+     */
+    void setPosLimits(int32_t lowLimit, int32_t highLimit)
+    {
+        if (lowLimit <= highLimit) {
+            posLimitLow = lowLimit;
+            posLimitHigh = highLimit;
+        }
+    }
+
+    /**
+     * @brief  see Derivs_Limiter::setPreventGoingWrongWay()
+     * @param  _preventGoingWrongWay: (bool)
+     * @retval None
+     */
+    void setPreventGoingWrongWay(bool _preventGoingWrongWay)
+    {
+        preventGoingWrongWay = _preventGoingWrongWay;
+    }
+
+    /**
+     * @brief  see Derivs_Limiter::setPreventGoingTooFast()
+     * @param  _preventGoingTooFast: (bool)
+     * @retval None
+     */
+    void setPreventGoingTooFast(bool _preventGoingTooFast)
+    {
+        preventGoingTooFast = _preventGoingTooFast;
+    }
+
+    /**
+     * @brief  set target position (doesn't run calculation)
+     * @param  _target: (int32_t) Q16.16
+     * @retval (bool) position==target
+     */
+    bool setTarget(int32_t _target)
+    {
+        target = _target;
+        posMode = true;
+        return isPosAtTarget();
+    }
+
+    /**
+     * @brief  set position
+     * @param  pos: (int32_t) Q16.16
+     * @retval None
+     */
+    void setPosition(int32_t pos)
+    {
+        position = (int64_t)pos << 24;
+    }
+
+    /**
+     * @brief  set velocity
+     * @param  vel: (int32_t) Q16.16 units per second
+     * @retval None
+     */
+    void setVelocity(int32_t vel)
+    {
+        velocity = vel;
+    }
+
+    /**
+     * @brief  switch to velocity mode, and set velocity immediately to a constant value
+     * @param  vel: (int32_t) Q16.16 units per second
+     * @retval None
+     */
+    void setVelConstant(int32_t vel)
+    {
+        posMode = false;
+        velocity = vel;
+        velocityTarget = vel;
+    }
+
+    /**
+     * @brief  switch to velocity mode, and set a target velocity that velocity goes towards limited by accelLimit and decelLimit
+     * @param  vel: (int32_t) Q16.16 units per second
+     * @retval None
+     */
+    void setVelTarget(int32_t vel)
+    {
+        posMode = false;
+        velocityTarget = vel;
+    }
+
+    /**
+     * @brief  get the current position, but doesn't calculate anything
+     * @retval (int32_t) Q16.16
+     */
+    int32_t getPosition()
+    {
+        return (int32_t)((position + ((int64_t)1 << 23)) >> 24);
+    }
+
+    /**
+     * @brief  get the current velocity
+     * @retval (int32_t) Q16.16 units per second
+     */
+    int32_t getVelocity()
+    {
+        return velocity;
+    }
+
+    /**
+     * @brief  get target position
+     * @retval (int32_t) Q16.16
+     */
+    int32_t getTarget()
+    {
+        return target;
+    }
+
+    /**
+     * @brief  does position equal target?
+     * @retval (bool)
+     */
+    bool isPosAtTarget()
+    {
+        return position == ((int64_t)target << 24);
+    }
+
+    /**
+     * @brief  If calc hasn't been run for a while, use this before starting to use it again to protect from large jumps.
+     * @retval None
+     */
+    void resetTime()
+    {
+        lastTime = micros();
+    }
+
+    /**
+     * @brief  call this as frequently as possible to calculate all the values
+     * @retval (int32_t) position, Q16.16
+     */
+    int32_t calc()
+    {
+        unsigned long now = micros();
+        unsigned long dt = now - lastTime;
+        if (lastTime == 0) {
+            dt = 0; // in case there's a delay between starting the program and the first calculation avoid jump at start
+        }
+        lastTime = now;
+        return step(dt);
+    }
+
+    /**
+     * @brief  run the calculation for a time interval that you give instead of reading micros()
+     * @param  dtMicros: (unsigned long) microseconds since the last calculation, limited to 60 seconds
+     * @retval (int32_t) position, Q16.16
+     */
+    int32_t step(unsigned long dtMicros)
+    {
+        if (dtMicros == 0) {
+            return getPosition();
+        }
+        if (dtMicros > 60000000UL) {
+            dtMicros = 60000000UL;
+        }
+        // seconds as Q8.24, 1099512 = 2^40 / 1000000
+        int32_t dt = (int32_t)(((uint64_t)dtMicros * 1099512UL) >> 16);
+
+        if (position > ((int64_t)posLimitHigh << 24)) {
+            setPosition(posLimitHigh);
+            velocity = 0;
+        } else if (position < ((int64_t)posLimitLow << 24)) {
+            setPosition(posLimitLow);
+            velocity = 0;
+        }
+        target = constrain(target, posLimitLow, posLimitHigh);
+
+        if (preventGoingTooFast) {
+            velocity = constrain(velocity, -velLimit, velLimit);
+        }
+        if (posMode) {
+            posModeStep(dt);
+        } else {
+            velModeStep(dt);
+        }
+        return getPosition();
+    }
+
+protected:
+    /**
+     * @brief  a * dt, with dt in seconds as Q8.24, rounded to nearest
+     * @param  a: (int32_t) Q16.16 per second
+     * @param  dt: (int32_t) Q8.24 seconds
+     * @retval (int32_t) Q16.16
+     */
+    static int32_t mulTime(int32_t a, int32_t dt)
+    {
+        return (int32_t)(((int64_t)a * dt + ((int64_t)1 << 23)) >> 24);
+    }
+
+    /**
+     * @brief  one step of position mode, see Derivs_Limiter_Kernel::posMode() for the version this follows
+     * @param  dt: (int32_t) Q8.24 seconds, greater than 0
+     * @retval None
+     */
+    void posModeStep(int32_t dt)
+    {
+        const int64_t target40 = (int64_t)target << 24;
+        int64_t toTarget = target40 - position; // Q24.40
+        if (preventGoingWrongWay && velocity != 0 && toTarget != 0 && ((velocity > 0) != (toTarget > 0))) { // going the wrong way
+            velocity = 0;
+        }
+        if (velocity == 0 && toTarget == 0) { // if stopped at the target, no calculations are needed
+            return;
+        }
+        int64_t dist = (toTarget < 0) ? -toTarget : toTarget; // Q24.40
+        int64_t velTime = (int64_t)velocity * dt; // Q24.40
+        if (velTime < 0) {
+            velTime = -velTime;
+        }
+        int32_t maxDecel = (int32_t)min((int64_t)decelLimit * maxStoppingDecel, (int64_t)INT32_MAX);
+        int32_t maxDecelTime = mulTime(maxDecel, dt);
+        // squared speeds and 2 * decel * distance are compared instead of dividing or taking square roots, all Q32.32
+        int64_t velSq = (int64_t)velocity * velocity;
+        int64_t stoppableSq = 2 * (int64_t)decelLimit * (dist >> 24); // v^2 = u^2 + 2as
+
+        if (velocity != 0 && toTarget != 0 && (velocity > 0) == (toTarget > 0)
+            && 2 * (int64_t)decelLimit * ((dist - velTime) >> 24) <= velSq) {
+            // predicted to be too close next time, decel now.
+            if (dist <= velTime && abs(velocity) <= maxDecelTime) { // close enough and slow enough, just stop
+                velocity = 0;
+                position = target40;
+            } else { // decel, harder if too fast to stop with decelLimit
+                int32_t change = mulTime((velSq > stoppableSq) ? maxDecel : decelLimit, dt);
+                if (change >= abs(velocity)) {
+                    velocity = 0;
+                } else {
+                    velocity += (velocity > 0) ? -change : change;
+                }
+                position += (int64_t)velocity * dt;
+            }
+        } else if (velocity != 0 && toTarget != 0 && (velocity > 0) != (toTarget > 0)) { // if going wrong way, decel
+            velocity += mulTime((toTarget > 0) ? decelLimit : -decelLimit, dt);
+            if (velocity != 0 && (velocity > 0) == (toTarget > 0)) { // switched direction, stop at zero velocity, in case accel is lower
+                velocity = 0;
+            } else {
+                position += (int64_t)velocity * dt;
+            }
+        } else if (abs(velocity) < velLimit) { // too slow, speed up
+            int32_t direction = (toTarget < 0) ? -1 : 1;
+            // fastest of: speed up at accelLimit, speed up at the lower of accelLimit and decelLimit, keep speed, or stop, that can still stop in time
+            int32_t newVelocity = constrain(velocity + direction * mulTime(accelLimit, dt), -velLimit, velLimit);
+            if ((int64_t)newVelocity * newVelocity > stoppableSq) {
+                newVelocity = constrain(velocity + direction * mulTime(min(accelLimit, decelLimit), dt), -velLimit, velLimit);
+                if ((int64_t)newVelocity * newVelocity > stoppableSq) {
+                    // Derivs_Limiter would limit speed to sqrt(2 * decelLimit * dist) and then stop at the target if that reaches it this step,
+                    // which happens when dist <= min(8, maxStoppingDecel^2 / 2) * decelLimit * dt^2.
+                    // If stopped, the target is closer than the smallest move that could be stopped in time (or than rounding lets stoppableSq show)
+                    int64_t decelDist = (int64_t)mulTime(decelLimit, dt) * dt; // Q24.40
+                    if ((velocity == 0 && decelLimit > 0) || 2 * dist <= min((int64_t)16, (int64_t)maxStoppingDecel * maxStoppingDecel) * decelDist) {
+                        velocity = 0;
+                        position = target40;
+                        return;
+                    }
+                    newVelocity = (velSq > stoppableSq) ? 0 : velocity;
+                }
+            }
+            velocity = newVelocity;
+            velTime = (int64_t)velocity * dt;
+            position += velTime;
+            toTarget = target40 - position;
+            if ((toTarget < 0 ? -toTarget : toTarget) <= (velTime < 0 ? -velTime : velTime) && abs(velocity) <= maxDecelTime) { // close enough and slow enough, just stop
+                velocity = 0;
+                position = target40;
+            }
+        } else if (abs(velocity) > velLimit) { // too fast, slow down
+            int32_t change = mulTime(decelLimit, dt);
+            if (velocity > 0) {
+                velocity = max(velocity - change, velLimit);
+            } else {
+                velocity = min(velocity + change, -velLimit);
+            }
+            position += (int64_t)velocity * dt;
+        } else { // coast, no accel
+            position += (int64_t)velocity * dt;
+        }
+    }
+
+    /**
+     * @brief  one step of velocity mode, see Derivs_Limiter_Kernel::velMode() for the version this follows
+     * @param  dt: (int32_t) Q8.24 seconds, greater than 0
+     * @retval None
+     */
+    void velModeStep(int32_t dt)
+    {
+        velocityTarget = constrain(velocityTarget, -velLimit, velLimit);
+        if (preventGoingWrongWay && velocity != 0 && velocityTarget != 0 && (velocity > 0) != (velocityTarget > 0)) {
+            velocity = 0;
+        }
+        if (velocity != velocityTarget) {
+            int32_t accelChange = mulTime(accelLimit, dt);
+            int32_t decelChange = mulTime(decelLimit, dt);
+            if (velocity == 0) {
+                velocity += constrain(velocityTarget - velocity, -accelChange, accelChange);
+            } else if (velocity > 0) {
+                velocity += constrain(velocityTarget - velocity, -decelChange, accelChange);
+                if (velocity < 0) { // prevent decel from crossing zero and causing accel
+                    velocity = 0;
+                }
+            } else { // velocity < 0
+                velocity += constrain(velocityTarget - velocity, -accelChange, decelChange);
+                if (velocity > 0) { // prevent decel from crossing zero and causing accel
+                    velocity = 0;
+                }
+            }
+        }
+        position += (int64_t)velocity * dt;
+    }
+};
+
+/**
+ * @brief  a constant converted to Q16.16 at compile time, for Derivs_Limiter_Fixed
+ */
+#define DL_FIXED(x) ((int32_t)((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))
+#endif
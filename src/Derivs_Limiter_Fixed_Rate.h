@@ -0,0 +1,392 @@
+#ifndef _DERIVS_LIMITER_FIXED_RATE_H_
+#define _DERIVS_LIMITER_FIXED_RATE_H_
+#include "Derivs_Limiter.h"
+#include "Derivs_Limiter_Mailbox.h"
+
+/**
+ * @brief  a Derivs_Limiter for a constant time step, like a hardware timer interrupt, with everything that only depends on the limits and the time step calculated ahead of time
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   The time step is set once, and tick() calculates one step without reading a clock. Products of the limits and the time step are worked out again only when a limit or the time step is set,
+ *         so a tick has no loop and at most two divisions and one square root, for a short and bounded time in an interrupt.
+ *         The step is Derivs_Limiter_Kernel::posMode() or velMode() given the kept Derivs_Limiter_Kernel::Cached_Products,
+ *         so position and velocity are the same as a Derivs_Limiter with the same settings run with step() using the same time step (extras/host/FixedRateMatch.cpp checks this bit for bit).
+ *         Acceleration is multiplied by 1/timestep instead of divided, so it can differ in the last bit.
+ *         Precomputing doesn't remove the divisions in a tick that slows down to the target: one is by the distance to the target, which changes every tick, and the one by 2 * decelLimit
+ *         is kept as a division because multiplying by a kept reciprocal rounds differently and would no longer match Derivs_Limiter. Those ticks only save the multiplications.
+ *         There's no jerk limit, profile, timed moves, pointers, or delta values (this isn't the same as Derivs_Limiter_Fixed, which uses integer math).
+ *         Setters must not run while tick() does: call them with interrupts off, or post commands to a Derivs_Limiter_Mailbox from the main loop with setMailbox().
+ * @tparam Scalar: float or double
+ */
+template <typename Scalar = float>
+class Derivs_Limiter_Fixed_Rate_T {
+protected:
+    Scalar position;
+    Scalar velocity;
+    Scalar accel;
+    Scalar target;
+    Scalar velocityTarget;
+    Scalar velLimit;
+    Scalar accelLimit;
+    Scalar decelLimit;
+    Scalar maxStoppingDecel;
+    Scalar posLimitLow;
+    Scalar posLimitHigh;
+    Scalar timestep;
+    bool posMode;
+    bool preventGoingWrongWay;
+    bool preventGoingTooFast;
+    Derivs_Limiter_Mailbox_T<Scalar>* mailbox;
+
+    Derivs_Limiter_Kernel::Cached_Products<Scalar> products; // worked out by updateCache() whenever a limit or the time step changes
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Fixed_Rate
+     * @param  _timestep: (float) default=0.001, seconds between calls of tick(), must be greater than 0
+     * @param  _velLimit: (float) default=0, velocity limit (units per second)
+     * @param  _accelLimit: (float) default=0, acceleration limit (units per second per second)
+     * @param  _decelLimit: (float) default=NAN, deceleration limit (units per second per second), set to NAN to use accelLimit
+     * @param  _startPos: (float) default=0, starting position and target
+     */
+    Derivs_Limiter_Fixed_Rate_T(Scalar _timestep = 0.001, Scalar _velLimit = 0, Scalar _accelLimit = 0, Scalar _decelLimit = NAN, Scalar _startPos = 0)
+    {
+        position = isnan(_startPos) ? 0 : _startPos;
+        velocity = 0;
+        accel = 0;
+        target = position;
+        velocityTarget = 0;
+        velLimit = abs(_velLimit);
+        accelLimit = abs(_accelLimit);
+        decelLimit = isnan(_decelLimit) ? accelLimit : abs(_decelLimit);
+        maxStoppingDecel = 2;
+        posLimitLow = -INFINITY;
+        posLimitHigh = INFINITY;
+        timestep = (_timestep > 0) ? _timestep : (Scalar)0.001;
+        posMode = true;
+        preventGoingWrongWay = false;
+        preventGoingTooFast = false;
+        mailbox = NULL;
+        updateCache();
+    }
+
+    /**
+     * @brief  set the time between calls of tick()
+     * @param  _timestep: (float) seconds, ignored if not greater than 0
+     * @retval None
+     */
+    void setTimestep(Scalar _timestep)
+    {
+        if (_timestep > 0) {
+            timestep = _timestep;
+            updateCache();
+        }
+    }
+
+    /**
+     * @brief  get the time step setting
+     * @retval (float) seconds
+     */
+    Scalar getTimestep()
+    {
+        return timestep;
+    }
+
+    /**
+     * @brief  set velocity limit
+     * @param  velLim: (float) ignored if NAN
+     * @retval None
+     */
+    void setVelLimit(Scalar velLim)
+    {
+        if (!isnan(velLim))
+            velLimit = abs(velLim);
+    }
+
+    /**
+     * @brief  set acceleration limit
+     * @param  accLim: (float) ignored if NAN
+     * @retval None
+     */
+    void setAccelLimit(Scalar accLim)
+    {
+        if (isnan(accLim))
+            return;
+        accelLimit = abs(accLim);
+        updateCache();
+    }
+
+    /**
+     * @brief  set deceleration limit
+     * @param  decLim: (float) set to NAN to use accelLimit
+     * @retval None
+     */
+    void setDecelLimit(Scalar decLim)
+    {
+        decelLimit = isnan(decLim) ? accelLimit : abs(decLim);
+        updateCache();
+    }
+
+    /**
+     * @brief  set velocity, acceleration, and deceleration limits
+     * @param  velLim: (float) ignored if NAN
+     * @param  accLim: (float) ignored if NAN
+     * @param  decLim: (float) default=NAN, set to NAN to use accelLimit
+     * @retval None
+     */
+    void setVelAccelLimits(Scalar velLim, Scalar accLim, Scalar decLim = NAN)
+    {
+        setVelLimit(velLim);
+        if (!isnan(accLim))
+            accelLimit = abs(accLim);
+        setDecelLimit(decLim);
+    }
+
+    /**
+     * @brief  how many times decelLimit can be used to stop in time for the target, see Derivs_Limiter::setMaxStoppingDecel()
+     * @param  _maxStoppingDecel: (float) 1 or more, ignored if NAN
+     * @retval None
+     */
+    void setMaxStoppingDecel(Scalar _maxStoppingDecel)
+    {
+        if (isnan(_maxStoppingDecel))
+            return;
+        maxStoppingDecel = max(_maxStoppingDecel, (Scalar)1.0);
+        updateCache();
+    }
+
+    /**
+     * @brief  set position limits
+     * @param  low: (float) ignored if NAN
+     * @param  high: (float) ignored if NAN, set to low if below low
+     * @retval None
+     */
+    void setPosLimits(Scalar low, Scalar high)
+    {
+        if (!isnan(low))
+            posLimitLow = low;
+        if (!isnan(high))
+            posLimitHigh = high;
+        posLimitHigh = max(posLimitHigh, posLimitLow);
+    }
+
+    /**
+     * @brief  stop immediately if velocity is going away from target
+     * @param  _preventGoingWrongWay: (bool)
+     * @retval None
+     */
+    void setPreventGoingWrongWay(bool _preventGoingWrongWay)
+    {
+        preventGoingWrongWay = _preventGoingWrongWay;
+    }
+
+    /**
+     * @brief  constrain velocity to within velLimit
+     * @param  _preventGoingTooFast: (bool)
+     * @retval None
+     */
+    void setPreventGoingTooFast(bool _preventGoingTooFast)
+    {
+        preventGoingTooFast = _preventGoingTooFast;
+    }
+
+    /**
+     * @brief  set a Derivs_Limiter_Mailbox to use, commands posted to it are applied at the start of the next tick()
+     * @param  _mailbox: (Derivs_Limiter_Mailbox*) NULL to not use
+     * @retval None
+     */
+    void setMailbox(Derivs_Limiter_Mailbox_T<Scalar>* _mailbox)
+    {
+        mailbox = _mailbox;
+    }
+
+    /**
+     * @brief  make every change in a command: limits first, then target (position mode) or velTarget (velocity mode), values that are NAN aren't changed
+     * @param  command: (Derivs_Limiter_Command)
+     * @retval None
+     */
+    void applyCommand(const Derivs_Limiter_Command_T<Scalar>& command)
+    {
+        setVelLimit(command.velLimit);
+        if (!isnan(command.accelLimit))
+            accelLimit = abs(command.accelLimit);
+        if (!isnan(command.decelLimit))
+            decelLimit = abs(command.decelLimit);
+        updateCache();
+        if (!isnan(command.target)) {
+            setTarget(command.target);
+        } else {
+            setVelTarget(command.velTarget);
+        }
+    }
+
+    /**
+     * @brief  set target position, switches to position mode
+     * @param  _target: (float) ignored if NAN
+     * @retval None
+     */
+    void setTarget(Scalar _target)
+    {
+        if (isnan(_target))
+            return;
+        target = _target;
+        posMode = true;
+    }
+
+    /**
+     * @brief  velocity approaches the set target with limited accel and decel, switches to velocity mode
+     * @param  vel: (float) ignored if NAN
+     * @retval None
+     */
+    void setVelTarget(Scalar vel)
+    {
+        if (isnan(vel))
+            return;
+        velocityTarget = vel;
+        posMode = false;
+    }
+
+    /**
+     * @brief  set position
+     * @param  pos: (float) ignored if NAN
+     * @retval None
+     */
+    void setPosition(Scalar pos)
+    {
+        if (!isnan(pos))
+            position = pos;
+    }
+
+    /**
+     * @brief  set velocity
+     * @param  vel: (float) ignored if NAN
+     * @retval None
+     */
+    void setVelocity(Scalar vel)
+    {
+        if (!isnan(vel))
+            velocity = vel;
+    }
+
+    /**
+     * @brief  get position
+     * @retval (float)
+     */
+    Scalar getPosition()
+    {
+        return position;
+    }
+
+    /**
+     * @brief  get velocity
+     * @retval (float)
+     */
+    Scalar getVelocity()
+    {
+        return velocity;
+    }
+
+    /**
+     * @brief  get acceleration, see the notes in Derivs_Limiter
+     * @retval (float)
+     */
+    Scalar getAcceleration()
+    {
+        return accel;
+    }
+
+    /**
+     * @brief  get target position
+     * @retval (float)
+     */
+    Scalar getTarget()
+    {
+        return target;
+    }
+
+    /**
+     * @brief  get velocity target
+     * @retval (float)
+     */
+    Scalar getVelTarget()
+    {
+        return velocityTarget;
+    }
+
+    /**
+     * @brief  get velocity limit setting
+     * @retval (float)
+     */
+    Scalar getVelLimit()
+    {
+        return velLimit;
+    }
+
+    /**
+     * @brief  get acceleration limit setting
+     * @retval (float)
+     */
+    Scalar getAccelLimit()
+    {
+        return accelLimit;
+    }
+
+    /**
+     * @brief  get deceleration limit setting
+     * @retval (float)
+     */
+    Scalar getDecelLimit()
+    {
+        return decelLimit;
+    }
+
+    /**
+     * @brief  is it in position mode (true) or velocity mode (false)
+     * @retval (bool)
+     */
+    bool isPosModeNotVelocity()
+    {
+        return posMode;
+    }
+
+    /**
+     * @brief  does position equal target? (and in position mode)
+     * @retval (bool)
+     */
+    bool isPosAtTarget()
+    {
+        return posMode && position == target;
+    }
+
+    /**
+     * @brief  calculate one time step, call every getTimestep() seconds (like from a timer interrupt)
+     * @retval (float) position
+     */
+    Scalar tick()
+    {
+        if (mailbox) {
+            Derivs_Limiter_Command_T<Scalar> command;
+            if (mailbox->take(command)) {
+                applyCommand(command);
+            }
+        }
+        Derivs_Limiter_Kernel::constrainToPosLimits(position, velocity, target, posLimitLow, posLimitHigh);
+        if (preventGoingTooFast) {
+            velocity = constrain(velocity, -velLimit, velLimit);
+        }
+        if (posMode) {
+            Derivs_Limiter_Kernel::posMode(position, velocity, accel, target, velLimit, preventGoingWrongWay, products);
+        } else {
+            Derivs_Limiter_Kernel::velMode(position, velocity, accel, velocityTarget, velLimit, preventGoingWrongWay, products);
+        }
+        return position;
+    }
+
+protected:
+    void updateCache()
+    {
+        products.set(accelLimit, decelLimit, maxStoppingDecel, timestep);
+    }
+};
+
+typedef Derivs_Limiter_Fixed_Rate_T<float> Derivs_Limiter_Fixed_Rate;
+#endif
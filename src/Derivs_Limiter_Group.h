@@ -0,0 +1,148 @@
+#ifndef _DERIVS_LIMITER_GROUP_H_
+#define _DERIVS_LIMITER_GROUP_H_
+#include "Derivs_Limiter_Pointer_Array.h"
+/**
+ * @brief  N Derivs_Limiters (axes) that are given targets together and arrive at the same time
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   setTargets() finds the axis that needs the longest to reach its target, then uses setTargetTimedMovePreferred() to fit every axis to that time.
+ *         Like the timed move functions, this changes velLimit (use resetVelLimitToOriginal() on an axis to undo it) and assumes the axes start stopped.
+ *         The group only holds pointers (see Derivs_Limiter_Pointer_Array for size(), setLimiter() and getLimiter()), the Derivs_Limiters stay usable on their own.
+ * @tparam N: number of axes
+ * @tparam Limiter: default=Derivs_Limiter, type of the axes, any Derivs_Limiter_T or class derived from Derivs_Limiter_Base (Derivs_Limiter_Compact has no timed moves, since its limits are shared)
+ */
+template <size_t N, typename Limiter = Derivs_Limiter>
+class Derivs_Limiter_Group : public Derivs_Limiter_Pointer_Array<N, Limiter> {
+protected:
+    typedef Derivs_Limiter_Pointer_Array<N, Limiter> Array;
+    typedef typename Limiter::ScalarType Scalar;
+    using Array::limiters;
+    Scalar duration;
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Group, set the axes with setLimiter()
+     */
+    Derivs_Limiter_Group()
+        : Array()
+    {
+        duration = 0;
+    }
+
+    /**
+     * @brief  constructor for Derivs_Limiter_Group
+     * @param  _limiters: array of N pointers to Derivs_Limiters
+     */
+    Derivs_Limiter_Group(Limiter* const* _limiters)
+        : Array(_limiters)
+    {
+        duration = 0;
+    }
+
+    /**
+     * @brief  set a target for every axis, with velocity limits changed so that all axes arrive at the same time, as soon as the slowest axis can
+     * @note   the axis that takes longest moves at its original velocity limit, see getMinTimeForMove()
+     * @param  targets: (float*) array of N targets, an axis with a NAN target isn't changed and isn't waited for
+     * @param  minTime: (float) default=0, the move takes at least this many seconds
+     * @retval (float) seconds the move should take
+     */
+    Scalar setTargets(const Scalar* targets, Scalar minTime = 0)
+    {
+        duration = isnan(minTime) ? 0 : abs(minTime);
+        for (size_t i = 0; i < N; i++) {
+            if (limiters[i] && !isnan(targets[i])) {
+                Scalar axisTime = limiters[i]->getMinTimeForMove(targets[i] - limiters[i]->getPosition());
+                duration = max(duration, axisTime);
+            }
+        }
+        for (size_t i = 0; i < N; i++) {
+            if (limiters[i] && !isnan(targets[i])) {
+                if (targets[i] == limiters[i]->getPosition() || duration == 0) {
+                    limiters[i]->setTarget(targets[i]);
+                } else {
+                    limiters[i]->setTargetTimedMovePreferred(targets[i], duration); // if rounding makes the slowest axis "impossible", it uses its original velocity limit, which is what it needs
+                }
+            }
+        }
+        return duration;
+    }
+
+    /**
+     * @brief  the time the last move given to setTargets() should take
+     * @retval (float) seconds
+     */
+    Scalar getDuration()
+    {
+        return duration;
+    }
+
+    /**
+     * @brief  are all axes at their targets?
+     * @retval (bool)
+     */
+    bool isPosAtTarget()
+    {
+        for (size_t i = 0; i < N; i++) {
+            if (limiters[i] && limiters[i]->isPosNotAtTarget()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief  are all axes idle? see Derivs_Limiter::isIdle()
+     * @retval (bool)
+     */
+    bool isIdle()
+    {
+        for (size_t i = 0; i < N; i++) {
+            if (limiters[i] && !limiters[i]->isIdle()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief  how long until the soonest event of any axis, see Derivs_Limiter::getTimeToNextEvent()
+     * @retval (float) seconds, INFINITY if every axis is idle
+     */
+    Scalar getTimeToNextEvent()
+    {
+        Scalar soonest = INFINITY;
+        for (size_t i = 0; i < N; i++) {
+            if (limiters[i]) {
+                soonest = min(soonest, limiters[i]->getTimeToNextEvent());
+            }
+        }
+        return soonest;
+    }
+
+    /**
+     * @brief  runs calc() on every axis
+     * @retval None
+     */
+    void calc()
+    {
+        for (size_t i = 0; i < N; i++) {
+            if (limiters[i]) {
+                limiters[i]->calc();
+            }
+        }
+    }
+
+    /**
+     * @brief  runs step(dt) on every axis, so they all use the same time interval
+     * @param  dt: (float) time in seconds since the last calculation
+     * @retval None
+     */
+    void step(Scalar dt)
+    {
+        for (size_t i = 0; i < N; i++) {
+            if (limiters[i]) {
+                limiters[i]->step(dt);
+            }
+        }
+    }
+};
+#endif
@@ -0,0 +1,217 @@
+#ifndef _DERIVS_LIMITER_MAILBOX_H_
+#define _DERIVS_LIMITER_MAILBOX_H_
+#include "Derivs_Limiter.h"
+#if !defined(__AVR__)
+#include <atomic>
+#endif
+
+/**
+ * @brief  a set of changes for a Derivs_Limiter that are made together, see Derivs_Limiter_Mailbox
+ * @note   every value starts as NAN, which means "don't change"
+ */
+template <typename Scalar = float>
+struct Derivs_Limiter_Command_T {
+    Scalar target; // switches to position mode
+    Scalar velTarget; // switches to velocity mode, ignored if target is also set
+    Scalar velLimit;
+    Scalar accelLimit;
+    Scalar decelLimit;
+
+    Derivs_Limiter_Command_T()
+    {
+        target = NAN;
+        velTarget = NAN;
+        velLimit = NAN;
+        accelLimit = NAN;
+        decelLimit = NAN;
+    }
+};
+
+/**
+ * @brief  passes Derivs_Limiter_Commands from one thread, core, or interrupt to a Derivs_Limiter running in another, without locks
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   Attach it with setMailbox(&mailbox), to a Derivs_Limiter that has the Mailbox feature (see Derivs_Limiter_Mailbox_Features) or a Derivs_Limiter_Fixed_Rate. post() can be called at any time from one other thread (or core, or interrupt), and the
+ *         Derivs_Limiter applies the newest command at the start of its next calculation, all values together.
+ *         Neither side ever waits: this is a sequence lock, post() marks the command as being written while it writes it,
+ *         and take() skips a command that was being written while it was read (it gets picked up at the next calculation instead).
+ *         Each value of the command is a std::atomic, written and read with relaxed ordering (the fences on the sequence number order them), so a copy that overlaps a write
+ *         is a mix of old and new values rather than a data race, and is thrown away. On AVR, which has one core, they're plain values kept in order with compiler barriers.
+ *         Only one thread may post() and only one may take() (the one running calc()). If post() is called several times between calculations only the newest command is used.
+ *         On AVR the sequence number is one byte, which can be read in one instruction, so the newest command is missed if exactly a multiple of 128 commands are posted between two calculations.
+ */
+template <typename Scalar = float>
+class Derivs_Limiter_Mailbox_T {
+protected:
+#if defined(__AVR__)
+    typedef uint8_t Sequence;
+    volatile Sequence sequence; // odd while a command is being written
+#else
+    typedef unsigned int Sequence;
+    std::atomic<Sequence> sequence; // odd while a command is being written
+#endif
+    Sequence lastTaken;
+#if defined(__AVR__)
+    Derivs_Limiter_Command_T<Scalar> command;
+#else
+    struct Atomic_Command {
+        std::atomic<Scalar> target;
+        std::atomic<Scalar> velTarget;
+        std::atomic<Scalar> velLimit;
+        std::atomic<Scalar> accelLimit;
+        std::atomic<Scalar> decelLimit;
+    };
+    Atomic_Command command;
+#endif
+
+public:
+    Derivs_Limiter_Mailbox_T()
+    {
+        sequence = 0;
+        lastTaken = 0;
+        write(command, Derivs_Limiter_Command_T<Scalar>());
+    }
+
+    /**
+     * @brief  give a command to the Derivs_Limiter, replacing any command that it hasn't taken yet
+     * @param  _command: (Derivs_Limiter_Command)
+     * @retval None
+     */
+    void post(const Derivs_Limiter_Command_T<Scalar>& _command)
+    {
+#if defined(__AVR__)
+        Sequence s = sequence;
+        sequence = s + 1;
+        __asm__ __volatile__("" ::: "memory"); // single core, only the compiler needs to be kept from reordering
+        write(command, _command);
+        __asm__ __volatile__("" ::: "memory");
+        sequence = s + 2;
+#else
+        Sequence s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        write(command, _command);
+        sequence.store(s + 2, std::memory_order_release);
+#endif
+    }
+
+    /**
+     * @brief  give a new target and limits to the Derivs_Limiter
+     * @param  target: (float) ignored if NAN
+     * @param  velLimit: (float) default=NAN, ignored if NAN
+     * @param  accelLimit: (float) default=NAN, ignored if NAN
+     * @param  decelLimit: (float) default=NAN, ignored if NAN
+     * @retval None
+     */
+    void postTarget(Scalar target, Scalar velLimit = NAN, Scalar accelLimit = NAN, Scalar decelLimit = NAN)
+    {
+        Derivs_Limiter_Command_T<Scalar> c;
+        c.target = target;
+        c.velLimit = velLimit;
+        c.accelLimit = accelLimit;
+        c.decelLimit = decelLimit;
+        post(c);
+    }
+
+    /**
+     * @brief  used by the Derivs_Limiter, gets the newest command if there is one it hasn't taken and it wasn't being written
+     * @param  out: (Derivs_Limiter_Command&) set to the command if true is returned
+     * @retval (bool) true if there's a new command
+     */
+    bool take(Derivs_Limiter_Command_T<Scalar>& out)
+    {
+#if defined(__AVR__)
+        Sequence s = sequence;
+        if ((s & 1) || s == lastTaken) {
+            return false;
+        }
+        __asm__ __volatile__("" ::: "memory");
+        read(out, command);
+        __asm__ __volatile__("" ::: "memory");
+        if (sequence != s) {
+            return false;
+        }
+#else
+        Sequence s = sequence.load(std::memory_order_acquire);
+        if ((s & 1) || s == lastTaken) {
+            return false;
+        }
+        read(out, command);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != s) {
+            return false;
+        }
+#endif
+        lastTaken = s;
+        return true;
+    }
+
+    /**
+     * @brief  is there a command that hasn't been taken yet
+     * @retval (bool)
+     */
+    bool isPending()
+    {
+        Sequence s = sequence;
+        return !(s & 1) && s != lastTaken;
+    }
+
+protected:
+#if defined(__AVR__)
+    static void write(Derivs_Limiter_Command_T<Scalar>& to, const Derivs_Limiter_Command_T<Scalar>& from)
+    {
+        to.target = from.target;
+        to.velTarget = from.velTarget;
+        to.velLimit = from.velLimit;
+        to.accelLimit = from.accelLimit;
+        to.decelLimit = from.decelLimit;
+    }
+    static void read(Derivs_Limiter_Command_T<Scalar>& to, const Derivs_Limiter_Command_T<Scalar>& from)
+    {
+        write(to, from);
+    }
+#else
+    static void write(Atomic_Command& to, const Derivs_Limiter_Command_T<Scalar>& from)
+    {
+        to.target.store(from.target, std::memory_order_relaxed);
+        to.velTarget.store(from.velTarget, std::memory_order_relaxed);
+        to.velLimit.store(from.velLimit, std::memory_order_relaxed);
+        to.accelLimit.store(from.accelLimit, std::memory_order_relaxed);
+        to.decelLimit.store(from.decelLimit, std::memory_order_relaxed);
+    }
+    static void read(Derivs_Limiter_Command_T<Scalar>& to, const Atomic_Command& from)
+    {
+        to.target = from.target.load(std::memory_order_relaxed);
+        to.velTarget = from.velTarget.load(std::memory_order_relaxed);
+        to.velLimit = from.velLimit.load(std::memory_order_relaxed);
+        to.accelLimit = from.accelLimit.load(std::memory_order_relaxed);
+        to.decelLimit = from.decelLimit.load(std::memory_order_relaxed);
+    }
+#endif
+};
+
+typedef Derivs_Limiter_Command_T<float> Derivs_Limiter_Command;
+typedef Derivs_Limiter_Mailbox_T<float> Derivs_Limiter_Mailbox;
+
+template <typename Scalar>
+struct Derivs_Limiter_Mailbox_Option<Scalar, true> {
+    Derivs_Limiter_Mailbox_T<Scalar>* mailbox;
+    void storeMailbox(Derivs_Limiter_Mailbox_T<Scalar>* _mailbox)
+    {
+        mailbox = _mailbox;
+    }
+    bool isMailboxPending()
+    {
+        return mailbox && mailbox->isPending();
+    }
+    template <typename Limiter>
+    void takeCommand(Limiter& limiter)
+    {
+        if (mailbox) {
+            Derivs_Limiter_Command_T<Scalar> command;
+            if (mailbox->take(command)) {
+                limiter.applyCommand(command);
+            }
+        }
+    }
+};
+#endif
@@ -0,0 +1,186 @@
+#ifndef _DERIVS_LIMITER_PARALLEL_H_
+#define _DERIVS_LIMITER_PARALLEL_H_
+#include "Derivs_Limiter.h"
+#if defined(__AVR__)
+#error "Derivs_Limiter_Parallel needs std::atomic, which AVR doesn't have"
+#endif
+#include <atomic>
+
+/**
+ * @brief  an array of limiters, in the form Derivs_Limiter_Parallel uses (Derivs_Limiter_Bank already has it)
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @tparam Limiter: default=Derivs_Limiter, type of the limiters, anything with step(dt) and a ScalarType typedef: any Derivs_Limiter_T, a class derived from Derivs_Limiter_Base, or Derivs_Limiter_Compact
+ */
+template <typename Limiter = Derivs_Limiter>
+class Derivs_Limiter_Array {
+public:
+    typedef typename Limiter::ScalarType Scalar;
+
+protected:
+    Limiter* limiters;
+    size_t count;
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Array
+     * @param  _limiters: (Limiter*) first of count limiters in an array
+     * @param  _count: (size_t)
+     */
+    Derivs_Limiter_Array(Limiter* _limiters, size_t _count)
+    {
+        limiters = _limiters;
+        count = _count;
+    }
+
+    /**
+     * @brief  number of limiters
+     * @retval (size_t)
+     */
+    size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief  runs step(dt) on some of the limiters
+     * @param  first: (size_t) first one
+     * @param  n: (size_t) number of limiters, stops at the end of the array
+     * @param  dt: (float) time in seconds since the last calculation
+     * @retval None
+     */
+    void stepRange(size_t first, size_t n, Scalar dt)
+    {
+        size_t end = (first >= count || n > count - first) ? count : first + n;
+        for (size_t i = first; i < end; i++) {
+            limiters[i].step(dt);
+        }
+    }
+};
+
+/**
+ * @brief  steps many Derivs_Limiters (or the channels of a Derivs_Limiter_Bank) on several threads or cores, one tick at a time
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   This doesn't start any threads. Start one thread (std::thread, or a FreeRTOS task pinned to each core) for each worker,
+ *         and have worker w call tick(w, dt) once per tick with the same dt (or run(w, ticks, dt)).
+ *         The items are split into one shard per worker, and each shard has one atomic cursor that every worker claims chunks from with fetch_add (there are no per-worker queues).
+ *         A worker claims chunks from its own shard first, then from the other shards' cursors in turn, so a worker that was slowed down (by an interrupt, or another task on its core)
+ *         doesn't hold up the tick as long as the others still have chunks left to claim.
+ *         tick() returns once every item has been stepped (a barrier), so the next tick, or code that reads the results, sees finished values.
+ *         Every item is stepped once per tick with the same dt, so the results are bit-identical to stepping them all in order on one thread,
+ *         no matter how many workers there are or which one steps which item. This only holds if the items don't share anything (like a position pointer to the same variable).
+ *         Waiting workers spin, calling the idle function if one is set (std::this_thread::yield on a computer, taskYIELD() on FreeRTOS).
+ *         A limiter step takes tens of nanoseconds, so the claims and the barrier every tick are only paid back with a core for each worker and many items per worker:
+ *         on one core extras/host/ParallelStep.cpp measures it a few percent slower than stepping in order.
+ * @tparam Items: what is stepped, a Derivs_Limiter_Array or a Derivs_Limiter_Bank (or any class with size() and stepRange(first, count, dt))
+ * @tparam Scalar: type of dt
+ * @tparam MaxWorkers: most workers that can be used
+ */
+template <typename Items, typename Scalar = float, size_t MaxWorkers = 8>
+class Derivs_Limiter_Parallel {
+protected:
+    struct alignas(64) Shard { // own cache line, so workers claiming chunks in different shards don't slow each other down
+        std::atomic<size_t> next;
+        size_t end;
+    };
+
+    Items* items;
+    size_t workers;
+    size_t chunk;
+    void (*idle)();
+    Shard shards[MaxWorkers];
+    alignas(64) std::atomic<size_t> arrived;
+    std::atomic<unsigned int> generation;
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Parallel
+     * @param  _items: (Items*) use &items
+     * @param  _workers: (size_t) number of threads that will call tick(), 1 to MaxWorkers
+     * @param  _chunk: (size_t) default=64, items stepped at a time, smaller spreads work out more evenly, larger has less overhead
+     * @param  _idle: (function pointer) default=NULL, called while waiting for other workers
+     */
+    Derivs_Limiter_Parallel(Items* _items, size_t _workers, size_t _chunk = 64, void (*_idle)() = NULL)
+    {
+        items = _items;
+        workers = constrain(_workers, (size_t)1, MaxWorkers);
+        chunk = max(_chunk, (size_t)1);
+        idle = _idle;
+        arrived = 0;
+        generation = 0;
+        resetShards();
+    }
+
+    /**
+     * @brief  number of workers
+     * @retval (size_t)
+     */
+    size_t getWorkers() const
+    {
+        return workers;
+    }
+
+    /**
+     * @brief  step every item once, call from every worker with the same dt, returns once all workers have finished the tick
+     * @param  worker: (size_t) which worker this is, 0 to getWorkers()-1, each worker must use a different number
+     * @param  dt: (float) time in seconds since the last calculation
+     * @retval None
+     */
+    void tick(size_t worker, Scalar dt)
+    {
+        for (size_t s = 0; s < workers; s++) {
+            Shard& shard = shards[(worker + s) % workers]; // own shard first, then take what's left in the others
+            while (true) {
+                size_t first = shard.next.fetch_add(chunk, std::memory_order_relaxed);
+                if (first >= shard.end) {
+                    break;
+                }
+                items->stepRange(first, min(chunk, shard.end - first), dt);
+            }
+        }
+        wait();
+    }
+
+    /**
+     * @brief  runs tick() a number of times, call from every worker
+     * @param  worker: (size_t) which worker this is, 0 to getWorkers()-1
+     * @param  ticks: (size_t)
+     * @param  dt: (float) time in seconds for each tick
+     * @retval None
+     */
+    void run(size_t worker, size_t ticks, Scalar dt)
+    {
+        for (size_t t = 0; t < ticks; t++) {
+            tick(worker, dt);
+        }
+    }
+
+protected:
+    void resetShards()
+    {
+        size_t n = items->size();
+        for (size_t w = 0; w < workers; w++) {
+            shards[w].next.store(n * w / workers, std::memory_order_relaxed);
+            shards[w].end = n * (w + 1) / workers;
+        }
+    }
+
+    /**
+     * @brief  barrier, the last worker to arrive gets the shards ready for the next tick and lets the others go
+     */
+    void wait()
+    {
+        unsigned int gen = generation.load(std::memory_order_relaxed);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == workers) {
+            resetShards();
+            arrived.store(0, std::memory_order_relaxed);
+            generation.store(gen + 1, std::memory_order_release);
+        } else {
+            while (generation.load(std::memory_order_acquire) == gen) {
+                if (idle) {
+                    idle();
+                }
+            }
+        }
+    }
+};
+#endif
@@ -0,0 +1,68 @@
+#ifndef _DERIVS_LIMITER_POINTER_ARRAY_H_
+#define _DERIVS_LIMITER_POINTER_ARRAY_H_
+#include "Derivs_Limiter.h"
+/**
+ * @brief  N pointers to limiters, the part Derivs_Limiter_Group and Derivs_Limiter_Dirty_List share
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   only holds pointers, the limiters stay usable on their own. A NULL pointer leaves that place empty.
+ * @tparam N: number of limiters
+ * @tparam Limiter: type of the limiters, any Derivs_Limiter_T or class derived from Derivs_Limiter_Base (a class using it may also allow others, like Derivs_Limiter_Compact)
+ */
+template <size_t N, typename Limiter = Derivs_Limiter>
+class Derivs_Limiter_Pointer_Array {
+protected:
+    Limiter* limiters[N];
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Pointer_Array, set the limiters with setLimiter()
+     */
+    Derivs_Limiter_Pointer_Array()
+    {
+        for (size_t i = 0; i < N; i++) {
+            limiters[i] = NULL;
+        }
+    }
+
+    /**
+     * @brief  constructor for Derivs_Limiter_Pointer_Array
+     * @param  _limiters: array of N pointers to limiters
+     */
+    Derivs_Limiter_Pointer_Array(Limiter* const* _limiters)
+    {
+        for (size_t i = 0; i < N; i++) {
+            limiters[i] = _limiters[i];
+        }
+    }
+
+    /**
+     * @brief  number of limiters
+     * @retval (size_t)
+     */
+    size_t size() const
+    {
+        return N;
+    }
+
+    /**
+     * @brief  set which limiter is at a place
+     * @param  i: (size_t) place
+     * @param  limiter: (Limiter*) use &limiter, NULL to leave the place empty
+     * @retval None
+     */
+    void setLimiter(size_t i, Limiter* limiter)
+    {
+        limiters[i] = limiter;
+    }
+
+    /**
+     * @brief  get the limiter at a place
+     * @param  i: (size_t) place
+     * @retval (Limiter*) can be NULL
+     */
+    Limiter* getLimiter(size_t i)
+    {
+        return limiters[i];
+    }
+};
+#endif
@@ -0,0 +1,246 @@
+#ifndef _DERIVS_LIMITER_PROFILE_H_
+#define _DERIVS_LIMITER_PROFILE_H_
+#include "Derivs_Limiter.h"
+/**
+ * @brief  a trapezoidal (or triangular) velocity profile that is solved once and can then be evaluated at any time
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   Attach one to a Derivs_Limiter that has the Profile feature (see Derivs_Limiter_Profile_Features) with setProfile(&profile) to make it follow a precomputed profile each time the target changes,
+ *         instead of integrating a little each calculation. The result doesn't depend on how often or how evenly calc() runs.
+ *         The Derivs_Limiter goes back to its normal calculation for the rest of the move if position, velocity, or a limit is changed during the move,
+ *         or if a move can't be planned (velocity away from the target, faster than velLimit, or too fast to stop in time).
+ *         A profile can also be used on its own with plan() and evaluate().
+ * @tparam Scalar: float or double
+ */
+template <typename Scalar = float>
+class Derivs_Limiter_Profile_T {
+protected:
+    Scalar startPos;
+    Scalar direction;
+    Scalar startVel; // speed at the start, towards the target
+    Scalar peakVel;
+    Scalar accelLimit;
+    Scalar decelLimit;
+    Scalar accelTime;
+    Scalar cruiseTime;
+    Scalar decelTime;
+    Scalar accelDist;
+    Scalar cruiseDist;
+    Scalar dist;
+    bool valid;
+
+    // used by step(), to know when the Derivs_Limiter was changed during a move
+    Scalar elapsed;
+    Scalar elapsedError; // the part of the time intervals that rounding left out of elapsed, added back on the next step
+    Scalar plannedTarget;
+    Scalar plannedVelLimit;
+    Scalar plannedAccelLimit;
+    Scalar plannedDecelLimit;
+    Scalar lastPos;
+    Scalar lastVel;
+    bool active;
+
+public:
+    Derivs_Limiter_Profile_T()
+    {
+        valid = false;
+        active = false;
+        elapsed = 0;
+        elapsedError = 0;
+        plannedTarget = NAN;
+        startPos = 0;
+        direction = 1;
+        startVel = 0;
+        peakVel = 0;
+        accelLimit = 0;
+        decelLimit = 0;
+        accelTime = 0;
+        cruiseTime = 0;
+        decelTime = 0;
+        accelDist = 0;
+        cruiseDist = 0;
+        dist = 0;
+        plannedVelLimit = 0;
+        plannedAccelLimit = 0;
+        plannedDecelLimit = 0;
+        lastPos = 0;
+        lastVel = 0;
+    }
+
+    /**
+     * @brief  solve the profile for a move
+     * @param  _startPos: (Scalar) position at time 0
+     * @param  _startVel: (Scalar) velocity at time 0, must be towards the target (or 0), no faster than velLimit, and slow enough to stop before the target
+     * @param  _target: (Scalar) position to stop at
+     * @param  _velLimit: (Scalar) can be INFINITY
+     * @param  _accelLimit: (Scalar) can be INFINITY
+     * @param  _decelLimit: (Scalar) can be INFINITY
+     * @retval (bool) true if the move could be planned (and isn't already finished)
+     */
+    bool plan(Scalar _startPos, Scalar _startVel, Scalar _target, Scalar _velLimit, Scalar _accelLimit, Scalar _decelLimit)
+    {
+        valid = false;
+        Scalar toTarget = _target - _startPos;
+        if (isnan(toTarget) || isnan(_startVel) || toTarget == 0 || !(_velLimit > 0) || !(_accelLimit > 0) || !(_decelLimit > 0)) {
+            return false;
+        }
+        direction = (toTarget > 0) ? 1 : -1;
+        Scalar u = _startVel * direction;
+        dist = abs(toTarget);
+        if (u < 0 || u > _velLimit || (_decelLimit != INFINITY && sq(u) > 2 * _decelLimit * dist)) {
+            return false;
+        }
+        bool accelInf = (_accelLimit == INFINITY);
+        bool decelInf = (_decelLimit == INFINITY);
+        Scalar vp;
+        if (accelInf && decelInf) {
+            if (_velLimit == INFINITY) {
+                return false; // no limits, nothing to plan
+            }
+            vp = _velLimit;
+        } else {
+            Scalar accelRamp = accelInf ? 0 : (sq(_velLimit) - sq(u)) / (2 * _accelLimit);
+            Scalar decelRamp = decelInf ? 0 : sq(_velLimit) / (2 * _decelLimit);
+            if (_velLimit != INFINITY && accelRamp + decelRamp <= dist) {
+                vp = _velLimit; // trapezoid
+            } else if (accelInf) {
+                vp = sqrt(2 * _decelLimit * dist); // triangle, v^2 = 2as
+            } else if (decelInf) {
+                vp = sqrt(sq(u) + 2 * _accelLimit * dist);
+            } else {
+                vp = sqrt((2 * _accelLimit * _decelLimit * dist + _decelLimit * sq(u)) / (_accelLimit + _decelLimit));
+            }
+        }
+        startPos = _startPos;
+        startVel = u;
+        peakVel = max(vp, u);
+        accelLimit = _accelLimit;
+        decelLimit = _decelLimit;
+        accelTime = accelInf ? 0 : (peakVel - u) / _accelLimit;
+        accelDist = accelInf ? 0 : (sq(peakVel) - sq(u)) / (2 * _accelLimit);
+        decelTime = decelInf ? 0 : peakVel / _decelLimit;
+        Scalar decelDist = decelInf ? 0 : sq(peakVel) / (2 * _decelLimit);
+        cruiseDist = max(dist - accelDist - decelDist, (Scalar)0);
+        cruiseTime = cruiseDist / peakVel;
+        valid = true;
+        return true;
+    }
+
+    /**
+     * @brief  is there a planned move
+     * @retval (bool)
+     */
+    bool isValid()
+    {
+        return valid;
+    }
+
+    /**
+     * @brief  how long the planned move takes
+     * @retval (Scalar) seconds, 0 if not valid
+     */
+    Scalar getDuration()
+    {
+        if (!valid)
+            return 0;
+        return accelTime + cruiseTime + decelTime;
+    }
+
+    /**
+     * @brief  position, velocity, and acceleration of the planned move at a time, in closed form
+     * @param  t: (Scalar) seconds since the start of the move
+     * @param  pos: (Scalar&) set to position
+     * @param  vel: (Scalar&) set to velocity
+     * @param  acc: (Scalar&) set to acceleration
+     * @retval (bool) false if t is past the end of the move (pos is the target, vel and acc are 0) or nothing is planned (nothing is changed)
+     */
+    bool evaluate(Scalar t, Scalar& pos, Scalar& vel, Scalar& acc)
+    {
+        if (!valid)
+            return false;
+        Scalar x;
+        Scalar v;
+        Scalar a;
+        if (t < accelTime) {
+            v = startVel + accelLimit * t;
+            x = startVel * t + accelLimit * sq(t) / 2;
+            a = accelLimit;
+        } else if (t < accelTime + cruiseTime) {
+            v = peakVel;
+            x = accelDist + peakVel * (t - accelTime);
+            a = 0;
+        } else if (t < accelTime + cruiseTime + decelTime) {
+            Scalar t3 = t - accelTime - cruiseTime;
+            v = peakVel - decelLimit * t3;
+            x = min(accelDist + cruiseDist + peakVel * t3 - decelLimit * sq(t3) / 2, dist);
+            a = -decelLimit;
+        } else {
+            pos = startPos + direction * dist;
+            vel = 0;
+            acc = 0;
+            return false;
+        }
+        pos = startPos + direction * x;
+        vel = direction * v;
+        acc = direction * a;
+        return true;
+    }
+
+    /**
+     * @brief  used by Derivs_Limiter, plans a move when target changes and follows it
+     * @retval (bool) true if position, velocity, and accel were set from the profile, false if the normal calculation should run
+     */
+    bool step(Scalar& position, Scalar& velocity, Scalar& accel, Scalar target, Scalar velLimit, Scalar _accelLimit, Scalar _decelLimit, Scalar time)
+    {
+        if (target != plannedTarget) {
+            plannedTarget = target;
+            plannedVelLimit = velLimit;
+            plannedAccelLimit = _accelLimit;
+            plannedDecelLimit = _decelLimit;
+            elapsed = 0;
+            elapsedError = 0;
+            active = plan(position, velocity, target, velLimit, _accelLimit, _decelLimit);
+        } else if (active && (position != lastPos || velocity != lastVel || velLimit != plannedVelLimit || _accelLimit != plannedAccelLimit || _decelLimit != plannedDecelLimit)) {
+            active = false; // changed during the move, go back to the normal calculation
+        }
+        if (!active) {
+            return false;
+        }
+        // compensated (Kahan) sum, so with float a long move made of many short intervals doesn't drift from its clock time
+        Scalar add = time - elapsedError;
+        Scalar sum = elapsed + add;
+        elapsedError = (sum - elapsed) - add;
+        elapsed = sum;
+        if (!evaluate(elapsed, position, velocity, accel)) {
+            position = target; // exactly
+            active = false;
+        }
+        lastPos = position;
+        lastVel = velocity;
+        return true;
+    }
+
+    /**
+     * @brief  is a Derivs_Limiter following this profile right now
+     * @retval (bool)
+     */
+    bool isActive()
+    {
+        return active;
+    }
+};
+
+typedef Derivs_Limiter_Profile_T<float> Derivs_Limiter_Profile;
+
+template <typename Scalar>
+struct Derivs_Limiter_Profile_Option<Scalar, true> {
+    Derivs_Limiter_Profile_T<Scalar>* profile;
+    void storeProfile(Derivs_Limiter_Profile_T<Scalar>* _profile)
+    {
+        profile = _profile;
+    }
+    bool stepProfile(Scalar& position, Scalar& velocity, Scalar& accel, Scalar target, Scalar velLimit, Scalar accelLimit, Scalar decelLimit, Scalar time)
+    {
+        return profile && profile->step(position, velocity, accel, target, velLimit, accelLimit, decelLimit, time);
+    }
+};
+#endif
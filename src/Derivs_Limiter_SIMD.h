@@ -0,0 +1,249 @@
+#ifndef _DERIVS_LIMITER_SIMD_H_
+#define _DERIVS_LIMITER_SIMD_H_
+#include "Derivs_Limiter.h"
+/**
+ * Vector versions of the Derivs_Limiter_Kernel functions, used by Derivs_Limiter_Bank to calculate several channels per instruction.
+ * Each lane's branch of the position mode calculation is picked with masks instead of jumps, and a branch is skipped only when no lane takes it,
+ * using the same operations in the same order as Derivs_Limiter_Kernel, so each lane matches the scalar result.
+ * That needs -ffp-contract=off (set by the CMake target for GCC and Clang, add it yourself in other builds): otherwise, where the CPU has fused multiply-add,
+ * the compiler can fuse a multiply and an add in the scalar code, which rounds once instead of twice, and the lanes no longer match.
+ *
+ * The instruction set is picked at compile time: AVX2 (8 lanes), SSE2 (4 lanes), or AArch64 NEON (4 lanes).
+ * extras/host/BankMatch checks the SSE2 path, BankMatchAVX2 the AVX2 path, and BankMatch built on AArch64 the NEON path. The NEON path hasn't been run on an AArch64 computer yet.
+ * If none are available, or DERIVS_LIMITER_NO_SIMD is defined, DERIVS_LIMITER_SIMD isn't defined and the bank uses the scalar kernel.
+ */
+
+#if !defined(DERIVS_LIMITER_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define DERIVS_LIMITER_SIMD
+/**
+ * @brief  8 floats, AVX (used when compiling for AVX2, with only AVX enabled this path measured slower than SSE2)
+ */
+struct Derivs_Limiter_SIMD {
+    static const size_t width = 8;
+    typedef __m256 F; // values
+    typedef __m256 M; // masks, all bits of a lane set for true
+    static F load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, F a) { _mm256_storeu_ps(p, a); }
+    static F set1(float a) { return _mm256_set1_ps(a); }
+    static F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F div(F a, F b) { return _mm256_div_ps(a, b); }
+    static F sqrt(F a) { return _mm256_sqrt_ps(a); }
+    static F neg(F a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static F abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static M lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static M le(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static M gt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static M eq(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static M ne(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); } // true for NAN like !=
+    static M andM(M a, M b) { return _mm256_and_ps(a, b); }
+    static M orM(M a, M b) { return _mm256_or_ps(a, b); }
+    static M xorM(M a, M b) { return _mm256_xor_ps(a, b); }
+    static M andNotM(M a, M b) { return _mm256_andnot_ps(b, a); } // a && !b
+    static F select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); } // m ? a : b
+    static bool any(M m) { return _mm256_movemask_ps(m) != 0; }
+    static M fromBools(const bool* b)
+    {
+        return _mm256_castsi256_ps(_mm256_set_epi32(-(int)b[7], -(int)b[6], -(int)b[5], -(int)b[4], -(int)b[3], -(int)b[2], -(int)b[1], -(int)b[0]));
+    }
+};
+
+#elif !defined(DERIVS_LIMITER_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define DERIVS_LIMITER_SIMD
+/**
+ * @brief  4 floats, SSE2
+ */
+struct Derivs_Limiter_SIMD {
+    static const size_t width = 4;
+    typedef __m128 F; // values
+    typedef __m128 M; // masks, all bits of a lane set for true
+    static F load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, F a) { _mm_storeu_ps(p, a); }
+    static F set1(float a) { return _mm_set1_ps(a); }
+    static F add(F a, F b) { return _mm_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F div(F a, F b) { return _mm_div_ps(a, b); }
+    static F sqrt(F a) { return _mm_sqrt_ps(a); }
+    static F neg(F a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static F abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static M lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static M le(F a, F b) { return _mm_cmple_ps(a, b); }
+    static M gt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+    static M eq(F a, F b) { return _mm_cmpeq_ps(a, b); }
+    static M ne(F a, F b) { return _mm_cmpneq_ps(a, b); } // true for NAN like !=
+    static M andM(M a, M b) { return _mm_and_ps(a, b); }
+    static M orM(M a, M b) { return _mm_or_ps(a, b); }
+    static M xorM(M a, M b) { return _mm_xor_ps(a, b); }
+    static M andNotM(M a, M b) { return _mm_andnot_ps(b, a); } // a && !b
+    static F select(M m, F a, F b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); } // m ? a : b
+    static bool any(M m) { return _mm_movemask_ps(m) != 0; }
+    static M fromBools(const bool* b)
+    {
+        return _mm_castsi128_ps(_mm_set_epi32(-(int)b[3], -(int)b[2], -(int)b[1], -(int)b[0]));
+    }
+};
+
+#elif !defined(DERIVS_LIMITER_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define DERIVS_LIMITER_SIMD
+/**
+ * @brief  4 floats, AArch64 NEON (32 bit ARM NEON has no vector divide or square root)
+ */
+struct Derivs_Limiter_SIMD {
+    static const size_t width = 4;
+    typedef float32x4_t F; // values
+    typedef uint32x4_t M; // masks, all bits of a lane set for true
+    static F load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, F a) { vst1q_f32(p, a); }
+    static F set1(float a) { return vdupq_n_f32(a); }
+    static F add(F a, F b) { return vaddq_f32(a, b); }
+    static F sub(F a, F b) { return vsubq_f32(a, b); }
+    static F mul(F a, F b) { return vmulq_f32(a, b); }
+    static F div(F a, F b) { return vdivq_f32(a, b); }
+    static F sqrt(F a) { return vsqrtq_f32(a); }
+    static F neg(F a) { return vnegq_f32(a); }
+    static F abs(F a) { return vabsq_f32(a); }
+    static M lt(F a, F b) { return vcltq_f32(a, b); }
+    static M le(F a, F b) { return vcleq_f32(a, b); }
+    static M gt(F a, F b) { return vcgtq_f32(a, b); }
+    static M eq(F a, F b) { return vceqq_f32(a, b); }
+    static M ne(F a, F b) { return vmvnq_u32(vceqq_f32(a, b)); } // true for NAN like !=
+    static M andM(M a, M b) { return vandq_u32(a, b); }
+    static M orM(M a, M b) { return vorrq_u32(a, b); }
+    static M xorM(M a, M b) { return veorq_u32(a, b); }
+    static M andNotM(M a, M b) { return vbicq_u32(a, b); } // a && !b
+    static F select(M m, F a, F b) { return vbslq_f32(m, a, b); } // m ? a : b
+    static bool any(M m) { return vmaxvq_u32(m) != 0; }
+    static M fromBools(const bool* b)
+    {
+        const uint32_t lanes[4] = { b[0] ? 0xFFFFFFFFu : 0u, b[1] ? 0xFFFFFFFFu : 0u, b[2] ? 0xFFFFFFFFu : 0u, b[3] ? 0xFFFFFFFFu : 0u };
+        return vld1q_u32(lanes);
+    }
+};
+#endif
+
+#ifdef DERIVS_LIMITER_SIMD
+/**
+ * @brief  Derivs_Limiter_Kernel for V::width channels at once, without branches
+ * @tparam V: vector operations, Derivs_Limiter_SIMD
+ */
+template <typename V>
+struct Derivs_Limiter_Vector_Kernel {
+    typedef typename V::F F;
+    typedef typename V::M M;
+
+    /**
+     * @brief  (x < low) ? low : ((x > high) ? high : x), same as constrain() including for NAN
+     */
+    static F constrainV(F x, F low, F high)
+    {
+        return V::select(V::lt(x, low), low, V::select(V::gt(x, high), high, x));
+    }
+
+    /**
+     * @brief  see Derivs_Limiter_Kernel::constrainToPosLimits()
+     */
+    static void constrainToPosLimits(F& position, F& velocity, F& target, F posLimitLow, F posLimitHigh)
+    {
+        M high = V::gt(position, posLimitHigh);
+        M low = V::andNotM(V::lt(position, posLimitLow), high);
+        position = V::select(high, posLimitHigh, V::select(low, posLimitLow, position));
+        velocity = V::select(V::orM(high, low), V::set1(0), velocity);
+        target = constrainV(target, posLimitLow, posLimitHigh);
+    }
+
+    /**
+     * @brief  see Derivs_Limiter_Kernel::posMode()
+     * @note   each lane takes exactly one branch, given by a mask, and a branch is only calculated if at least one lane takes it
+     */
+    static void posMode(F& position, F& velocity, F& accel, F target, F velLimit, F accelLimit,
+        F decelLimit, F maxStoppingDecel, M preventGoingWrongWay, F time)
+    {
+        const F zero = V::set1(0);
+        const F toTarget = V::sub(target, position);
+        const M towardsPositive = V::gt(toTarget, zero);
+        const M notAtTarget = V::ne(target, position);
+
+        // going the wrong way with preventGoingWrongWay, stop immediately
+        M wrongWay = V::andM(V::andM(V::ne(velocity, zero), notAtTarget), V::xorM(V::gt(velocity, zero), towardsPositive));
+        velocity = V::select(V::andM(preventGoingWrongWay, wrongWay), zero, velocity);
+
+        const M moving = V::ne(velocity, zero);
+        const M active = V::orM(moving, notAtTarget); // lanes stopped at the target need no calculation
+        accel = zero;
+        if (!V::any(active)) {
+            return;
+        }
+        const M velPositive = V::gt(velocity, zero);
+        const M directionsDiffer = V::xorM(velPositive, towardsPositive);
+        const M movingNotAtTarget = V::andM(moving, notAtTarget);
+        wrongWay = V::andM(movingNotAtTarget, directionsDiffer);
+
+        const F dist = V::abs(toTarget);
+        const F velTime = V::abs(V::mul(velocity, time));
+        const F maxDecel = V::mul(decelLimit, maxStoppingDecel);
+        const F maxDecelTime = V::mul(maxDecel, time);
+        const F half = V::set1(0.5f);
+        const F twoDecelLimit = V::mul(V::set1(2), decelLimit);
+        const F velSq = V::mul(velocity, velocity);
+        const F absVel = V::abs(velocity);
+
+        const M decel = V::andM(V::andNotM(movingNotAtTarget, directionsDiffer), V::le(V::sub(dist, velTime), V::div(velSq, twoDecelLimit)));
+        const M rest = V::andNotM(V::andNotM(active, decel), wrongWay);
+        const M tooSlow = V::andM(rest, V::lt(absVel, velLimit));
+        const M tooFast = V::andM(rest, V::gt(absVel, velLimit));
+
+        // coast, no accel (lanes in other branches get replaced below)
+        F newPos = V::add(position, V::mul(velocity, time));
+        F newVel = velocity;
+        F newAccel = zero;
+
+        if (V::any(decel)) { // predicted to be too close next time, decel now, or stop if close enough and slow enough
+            const M snap = V::andM(V::le(dist, velTime), V::le(absVel, maxDecelTime));
+            const F a = constrainV(V::div(V::mul(V::neg(velSq), half), toTarget), V::neg(maxDecel), maxDecel);
+            const F v = V::add(velocity, V::mul(a, time));
+            const F p = V::add(position, V::mul(v, time));
+            newPos = V::select(decel, V::select(snap, target, p), newPos);
+            newVel = V::select(decel, V::select(snap, zero, v), newVel);
+            newAccel = V::select(decel, V::select(snap, zero, a), newAccel);
+        }
+        if (V::any(wrongWay)) { // going wrong way, decel, stopping at zero velocity if direction switched
+            const F a = V::select(towardsPositive, decelLimit, V::neg(decelLimit));
+            const F v = V::add(velocity, V::mul(a, time));
+            const M switched = V::andNotM(V::ne(v, zero), V::xorM(V::gt(v, zero), towardsPositive));
+            newPos = V::select(wrongWay, V::select(switched, position, V::add(position, V::mul(v, time))), newPos);
+            newVel = V::select(wrongWay, V::select(switched, zero, v), newVel);
+            newAccel = V::select(wrongWay, V::select(switched, zero, a), newAccel);
+        }
+        if (V::any(tooSlow)) { // speed up without going faster than can be stopped (v^2 = u^2 + 2as), or stop if close enough and slow enough
+            F v = V::add(velocity, V::mul(V::select(V::gt(position, target), V::neg(accelLimit), accelLimit), time));
+            v = constrainV(v, V::neg(velLimit), velLimit);
+            const F maxSpeedThatCanBeStopped = V::sqrt(V::mul(twoDecelLimit, dist));
+            v = constrainV(v, V::neg(maxSpeedThatCanBeStopped), maxSpeedThatCanBeStopped);
+            const F a = V::div(V::sub(v, velocity), time);
+            const F p = V::add(position, V::mul(v, time));
+            const M snap = V::andM(V::le(V::abs(V::sub(p, target)), V::abs(V::mul(v, time))), V::le(V::abs(v), maxDecelTime));
+            newPos = V::select(tooSlow, V::select(snap, target, p), newPos);
+            newVel = V::select(tooSlow, V::select(snap, zero, v), newVel);
+            newAccel = V::select(tooSlow, V::select(snap, zero, a), newAccel);
+        }
+        if (V::any(tooFast)) { // too fast, slow down to velLimit
+            const F decelTime = V::mul(decelLimit, time);
+            F v = V::add(velocity, V::select(velPositive, V::neg(decelTime), decelTime));
+            v = V::select(velPositive, V::select(V::lt(v, velLimit), velLimit, v), V::select(V::gt(v, V::neg(velLimit)), V::neg(velLimit), v));
+            newPos = V::select(tooFast, V::add(position, V::mul(v, time)), newPos);
+            newVel = V::select(tooFast, v, newVel);
+            newAccel = V::select(tooFast, V::div(V::sub(v, velocity), time), newAccel);
+        }
+
+        position = V::select(active, newPos, position);
+        velocity = V::select(active, newVel, velocity);
+        accel = V::select(active, newAccel, zero);
+    }
+};
+#endif
+#endif
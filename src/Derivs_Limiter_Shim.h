@@ -0,0 +1,92 @@
+#ifndef _DERIVS_LIMITER_SHIM_H_
+#define _DERIVS_LIMITER_SHIM_H_
+/**
+ * The few parts of Arduino.h that Derivs_Limiter uses, so that the library can be compiled on a computer
+ * (for testing, profiling, and simulating) without any Arduino core.
+ * Derivs_Limiter.h includes this file automatically when ARDUINO and ESP_PLATFORM are not defined.
+ *
+ * micros() reads std::chrono::steady_clock unless another time source is set with derivsLimiterSetMicrosSource(),
+ * which lets a simulation step time forwards by exact amounts.
+ */
+#include <chrono>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+typedef bool boolean;
+
+template <typename T>
+inline T sq(T x)
+{
+    return x * x;
+}
+
+template <typename T>
+inline T constrain(T amt, T low, T high)
+{
+    return (amt < low) ? low : ((amt > high) ? high : amt);
+}
+
+template <typename T>
+inline T abs(T x)
+{
+    return (x > 0) ? x : -x;
+}
+
+template <typename T>
+inline T max(T a, T b)
+{
+    return (a > b) ? a : b;
+}
+
+template <typename T>
+inline T min(T a, T b)
+{
+    return (a < b) ? a : b;
+}
+
+/**
+ * @brief  function that returns a time in microseconds, like micros()
+ */
+typedef unsigned long (*Derivs_Limiter_Micros_Source)();
+
+/**
+ * @brief  the default time source, microseconds from std::chrono::steady_clock
+ * @note   never 0 in practice, Derivs_Limiter uses lastTime == 0 to mean calc() has never run
+ * @retval (unsigned long)
+ */
+inline unsigned long derivsLimiterSteadyMicros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief  the time source that micros() currently calls
+ * @retval (Derivs_Limiter_Micros_Source&)
+ */
+inline Derivs_Limiter_Micros_Source& derivsLimiterMicrosSource()
+{
+    static Derivs_Limiter_Micros_Source source = derivsLimiterSteadyMicros;
+    return source;
+}
+
+/**
+ * @brief  replace the time source used by micros() and millis()
+ * @param  source: (Derivs_Limiter_Micros_Source) function returning microseconds, NULL restores the steady_clock source
+ * @retval None
+ */
+inline void derivsLimiterSetMicrosSource(Derivs_Limiter_Micros_Source source)
+{
+    derivsLimiterMicrosSource() = source ? source : derivsLimiterSteadyMicros;
+}
+
+inline unsigned long micros()
+{
+    return derivsLimiterMicrosSource()();
+}
+
+inline unsigned long millis()
+{
+    return micros() / 1000;
+}
+#endif
@@ -0,0 +1,233 @@
+#ifndef _DERIVS_LIMITER_STEPPER_H_
+#define _DERIVS_LIMITER_STEPPER_H_
+#include "Derivs_Limiter.h"
+#if !defined(__AVR__)
+#include <atomic>
+#endif
+
+/**
+ * @brief  one step pulse for a stepper motor, made by Derivs_Limiter_Stepper
+ */
+struct Derivs_Limiter_Stepper_Pulse {
+    unsigned long interval; // timer ticks since the previous pulse, 0 means right away
+    bool forward; // direction, set the direction pin before the pulse
+};
+
+/**
+ * @brief  turns the motion of a Derivs_Limiter into step pulses for a stepper motor, timed to the timer tick, in a queue that a timer interrupt takes them from
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   Position is in units, and a step is taken each time position * stepsPerUnit passes halfway between two whole numbers, so the step count is always position * stepsPerUnit rounded.
+ *         refill(), called often from the loop, calculates the limiter ahead of time with step(planStep) and puts the time of each step into the queue.
+ *         The interrupt takes one pulse at a time with take() and sets its timer to fire after that many ticks, so it does no math and steps can be much faster than the loop.
+ *         Only refill() moves the limiter, don't run calc() or step() on it. Change its target, limits, or mode at any time from the same thread as refill():
+ *         the change is used for everything not yet in the queue, and refill() calculates at most lookahead seconds ahead of the clock, so changes take effect within about that long.
+ *         While the limiter isIdle() nothing is calculated and no time passes, so the first pulse of the next move is timed from when the interrupt takes it if the queue had run empty.
+ *         If refill() isn't called for longer than lookahead, the move carries on from where it was instead of trying to catch up.
+ *         One thread (or the loop) calls refill() and one interrupt (or thread) calls take(), neither waits for the other.
+ * @tparam Capacity: pulses the queue can hold plus one, up to 256 on AVR
+ * @tparam Limiter: default=Derivs_Limiter, type of the limiter, any Derivs_Limiter_T or class derived from Derivs_Limiter_Base. Its Clock keeps refill() from calculating too far ahead,
+ *         in the Clock's units (see Derivs_Limiter_Clock_Rate).
+ */
+template <size_t Capacity = 64, typename Limiter = Derivs_Limiter>
+class Derivs_Limiter_Stepper {
+protected:
+    typedef typename Limiter::ScalarType Scalar;
+    typedef typename Limiter::ClockType Clock;
+
+#if defined(__AVR__)
+    static_assert(Capacity >= 2 && Capacity <= 256, "Derivs_Limiter_Stepper Capacity must be 2 to 256 on AVR");
+    typedef uint8_t Index;
+    volatile Index head; // next to be written, only changed by refill()
+    volatile Index tail; // next to be taken, only changed by take()
+#else
+    static_assert(Capacity >= 2, "Derivs_Limiter_Stepper Capacity must be at least 2");
+    typedef size_t Index;
+    std::atomic<Index> head; // next to be written, only changed by refill()
+    std::atomic<Index> tail; // next to be taken, only changed by take()
+#endif
+    Derivs_Limiter_Stepper_Pulse pulses[Capacity];
+
+    // only used by refill()
+    Limiter* limiter;
+    Scalar stepsPerUnit;
+    unsigned long ticksPerSecond;
+    unsigned long planTicks; // ticks in each calculation
+    Scalar planStep; // planTicks in seconds
+    Scalar lookahead;
+    long stepPosition; // steps in the queue and already taken
+    Scalar lastSteps; // position * stepsPerUnit at the start of the current calculation
+    Scalar steps; // position * stepsPerUnit at its end
+    unsigned long planTick; // tick at the end of the current calculation
+    unsigned long lastPulseTick;
+    unsigned long syncTick; // planTick when the clock read syncClock, to compare how far ahead refill() is
+    unsigned long syncClock;
+    bool synced;
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Stepper
+     * @param  _limiter: (Limiter*) use &limiter
+     * @param  _stepsPerUnit: (float) default=1, steps for each unit of position
+     * @param  _ticksPerSecond: (unsigned long) default=1000000, rate of the timer that the interrupt uses to time pulses
+     * @param  _planStep: (float) default=0.001, seconds of each calculation refill() does, rounded to whole ticks, shorter follows the limiter more closely but takes more time
+     * @param  _lookahead: (float) default=0.02, refill() doesn't calculate more than this many seconds ahead of the clock
+     */
+    Derivs_Limiter_Stepper(Limiter* _limiter, Scalar _stepsPerUnit = 1, unsigned long _ticksPerSecond = 1000000,
+        Scalar _planStep = 0.001, Scalar _lookahead = 0.02)
+    {
+        head = 0;
+        tail = 0;
+        limiter = _limiter;
+        stepsPerUnit = (_stepsPerUnit > 0) ? _stepsPerUnit : 1;
+        ticksPerSecond = max(_ticksPerSecond, 1ul);
+        planTicks = max((unsigned long)(abs(_planStep) * ticksPerSecond + (Scalar)0.5), 1ul);
+        planStep = planTicks / (Scalar)ticksPerSecond;
+        lookahead = isnan(_lookahead) ? 0 : abs(_lookahead);
+        steps = limiter->getPosition() * stepsPerUnit;
+        lastSteps = steps;
+        stepPosition = (long)floor(steps + (Scalar)0.5);
+        planTick = 0;
+        lastPulseTick = 0;
+        syncTick = 0;
+        syncClock = 0;
+        synced = false;
+    }
+
+    /**
+     * @brief  calculate ahead and put new pulses in the queue, until it's full or lookahead seconds ahead of the clock, call often from the loop
+     * @retval (size_t) number of pulses added
+     */
+    size_t refill()
+    {
+        unsigned long now = Clock::now();
+        size_t added = 0;
+        while (true) {
+            // pulses in the current calculation
+            while (steps >= stepPosition + (Scalar)0.5 || steps <= stepPosition - (Scalar)0.5) {
+                bool forward = steps > stepPosition;
+                Scalar boundary = forward ? stepPosition + (Scalar)0.5 : stepPosition - (Scalar)0.5;
+                Scalar fraction = 0; // of the way through the calculation
+                if (steps != lastSteps) {
+                    fraction = constrain((boundary - lastSteps) / (steps - lastSteps), (Scalar)0, (Scalar)1);
+                }
+                unsigned long tick = planTick - planTicks + (unsigned long)(fraction * planTicks + (Scalar)0.5);
+                if ((long)(tick - lastPulseTick) < 0) {
+                    tick = lastPulseTick;
+                }
+                Derivs_Limiter_Stepper_Pulse pulse;
+                pulse.interval = tick - lastPulseTick;
+                pulse.forward = forward;
+                if (!push(pulse)) {
+                    return added;
+                }
+                lastPulseTick = tick;
+                stepPosition += forward ? 1 : -1;
+                added++;
+            }
+
+            if (limiter->isIdle()) { // no time passes, the next move is timed from when it starts
+                synced = false;
+                return added;
+            }
+            if (!synced) {
+                syncTick = planTick;
+                syncClock = now;
+                synced = true;
+            }
+            Scalar ahead = (planTick - syncTick) / (Scalar)ticksPerSecond - (now - syncClock) / (Scalar)Derivs_Limiter_Clock_Rate<Clock>::ticksPerSecond;
+            if (ahead >= lookahead) {
+                return added;
+            }
+            if (ahead < -lookahead) { // refill() wasn't called for a while, carry on from here instead of catching up
+                syncTick = planTick;
+                syncClock = now;
+            }
+
+            limiter->step(planStep);
+            lastSteps = steps;
+            steps = limiter->getPosition() * stepsPerUnit;
+            planTick += planTicks;
+        }
+    }
+
+    /**
+     * @brief  used by the interrupt, get the next pulse
+     * @param  out: (Derivs_Limiter_Stepper_Pulse&) set to the pulse if true is returned
+     * @retval (bool) false if the queue is empty
+     */
+    bool take(Derivs_Limiter_Stepper_Pulse& out)
+    {
+#if defined(__AVR__)
+        Index t = tail;
+        if (t == head) {
+            return false;
+        }
+        __asm__ __volatile__("" ::: "memory"); // single core, only the compiler needs to be kept from reordering
+        out = pulses[t];
+        __asm__ __volatile__("" ::: "memory");
+        tail = (t + 1) % Capacity;
+#else
+        Index t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = pulses[t];
+        tail.store((t + 1) % Capacity, std::memory_order_release);
+#endif
+        return true;
+    }
+
+    /**
+     * @brief  number of pulses in the queue
+     * @retval (size_t)
+     */
+    size_t available()
+    {
+        Index h = head;
+        Index t = tail;
+        return (h + Capacity - t) % Capacity;
+    }
+
+    /**
+     * @brief  the step count once every pulse in the queue has been taken, position * stepsPerUnit rounded
+     * @retval (long)
+     */
+    long getStepPosition()
+    {
+        return stepPosition;
+    }
+
+    /**
+     * @brief  get the limiter
+     * @retval (Limiter*)
+     */
+    Limiter* getLimiter()
+    {
+        return limiter;
+    }
+
+protected:
+    bool push(const Derivs_Limiter_Stepper_Pulse& pulse)
+    {
+#if defined(__AVR__)
+        Index h = head;
+        Index next = (h + 1) % Capacity;
+        if (next == tail) {
+            return false;
+        }
+        pulses[h] = pulse;
+        __asm__ __volatile__("" ::: "memory");
+        head = next;
+#else
+        Index h = head.load(std::memory_order_relaxed);
+        Index next = (h + 1) % Capacity;
+        if (next == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        pulses[h] = pulse;
+        head.store(next, std::memory_order_release);
+#endif
+        return true;
+    }
+};
+#endif
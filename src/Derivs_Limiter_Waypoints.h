@@ -0,0 +1,233 @@
+#ifndef _DERIVS_LIMITER_WAYPOINTS_H_
+#define _DERIVS_LIMITER_WAYPOINTS_H_
+#include "Derivs_Limiter.h"
+/**
+ * @brief  a queue of up to Capacity positions for a Derivs_Limiter to go through in order, without stopping at the ones it can pass through
+ * https://github.com/joshua-8/Derivs_Limiter
+ * @note   A waypoint where the direction of travel reverses, and the last one, are stopped at. Every other waypoint is passed at the highest speed (the junction speed)
+ *         from which the limiter can still slow down at decelLimit for the stops after it, and no faster than velLimit.
+ *         update() does this by setting the target past the next waypoint by the distance it takes to slow down from the junction speed (or by a time interval's distance
+ *         at the junction speed, if that's more), so the normal calculation limits everything as usual, and moves on to the next waypoint once position gets to (or past) it,
+ *         or for a waypoint it stops at, once it has stopped there. Call update() before every calc() or step(), or use calc() and step() of this class.
+ *         The waypoints are in a fixed array, nothing is allocated. The queue only holds a pointer, the Derivs_Limiter stays usable on its own, but setting its target while the queue has waypoints has no lasting effect.
+ * @tparam Capacity: most waypoints that can be queued
+ * @tparam Limiter: default=Derivs_Limiter, type of the limiter, any Derivs_Limiter_T or class derived from Derivs_Limiter_Base (Derivs_Limiter_Compact has no clock or limits of its own)
+ */
+template <size_t Capacity = 16, typename Limiter = Derivs_Limiter>
+class Derivs_Limiter_Waypoints {
+protected:
+    typedef typename Limiter::ScalarType Scalar;
+
+    Limiter* limiter;
+    Scalar waypoints[Capacity];
+    size_t first;
+    size_t count;
+    Scalar from; // where the move to the first waypoint started, the last waypoint reached
+    bool planned; // target set for the first waypoint with these limits
+    Scalar plannedVelLimit;
+    Scalar plannedDecelLimit;
+    Scalar junctionSpeed;
+    Scalar brakingDistance; // from the junction speed at decelLimit
+    Scalar runDistance; // from the first waypoint to the stop after it
+
+public:
+    /**
+     * @brief  constructor for Derivs_Limiter_Waypoints
+     * @param  _limiter: (Limiter*) use &limiter
+     */
+    Derivs_Limiter_Waypoints(Limiter* _limiter)
+    {
+        limiter = _limiter;
+        first = 0;
+        count = 0;
+        from = 0;
+        planned = false;
+        plannedVelLimit = 0;
+        plannedDecelLimit = 0;
+        junctionSpeed = 0;
+        brakingDistance = 0;
+        runDistance = 0;
+    }
+
+    /**
+     * @brief  add a waypoint to the end of the queue
+     * @param  position: (float)
+     * @retval (bool) false if the queue is full or position is NAN (nothing is added)
+     */
+    bool add(Scalar position)
+    {
+        if (count >= Capacity || isnan(position)) {
+            return false;
+        }
+        if (count == 0) {
+            from = limiter->getPosition();
+        }
+        waypoints[(first + count) % Capacity] = position;
+        count++;
+        planned = false;
+        return true;
+    }
+
+    /**
+     * @brief  remove every waypoint, the limiter keeps the target it has (which can be past the next waypoint)
+     * @retval None
+     */
+    void clear()
+    {
+        count = 0;
+        planned = false;
+    }
+
+    /**
+     * @brief  number of waypoints in the queue, including the one being moved to
+     * @retval (size_t)
+     */
+    size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief  is the queue full?
+     * @retval (bool)
+     */
+    bool isFull() const
+    {
+        return count >= Capacity;
+    }
+
+    /**
+     * @brief  get a waypoint
+     * @param  i: (size_t) 0 is the one being moved to
+     * @retval (float) NAN if there isn't one
+     */
+    Scalar get(size_t i)
+    {
+        if (i >= count) {
+            return NAN;
+        }
+        return waypoints[(first + i) % Capacity];
+    }
+
+    /**
+     * @brief  the speed the limiter can pass the waypoint it's moving to at, as of the last update()
+     * @retval (float) 0 if it stops there
+     */
+    Scalar getJunctionSpeed()
+    {
+        return junctionSpeed;
+    }
+
+    /**
+     * @brief  moves on past waypoints that have been reached, and sets the limiter's target for the next one
+     * @retval (bool) true while there are waypoints left
+     */
+    bool update()
+    {
+        Scalar position = limiter->getPosition();
+        while (count > 0) {
+            Scalar waypoint = waypoints[first];
+            Scalar direction = (waypoint > from) ? 1 : -1;
+            if (waypoint != from && direction * (position - waypoint) < 0) {
+                break; // not there yet
+            }
+            bool stop = (count == 1 || direction * (waypoints[(first + 1) % Capacity] - waypoint) <= 0);
+            if (waypoint != from && stop && !(limiter->getVelocity() == 0 && limiter->isPosAtTarget())) {
+                break; // still slowing down (or stopped just past it, and about to go back to it), moving on now would turn around before stopping there
+            }
+            from = waypoint;
+            first = (first + 1) % Capacity;
+            count--;
+            planned = false;
+        }
+        if (count == 0) {
+            junctionSpeed = 0;
+            return false;
+        }
+        if (!planned || limiter->getVelLimit() != plannedVelLimit || limiter->getDecelLimit() != plannedDecelLimit) {
+            plan();
+        }
+        aim();
+        return true;
+    }
+
+    /**
+     * @brief  update(), then calc() of the limiter
+     * @retval (float) position
+     */
+    Scalar calc()
+    {
+        update();
+        return limiter->calc();
+    }
+
+    /**
+     * @brief  update(), then step(dt) of the limiter
+     * @param  dt: (float) time in seconds since the last calculation
+     * @retval (float) position
+     */
+    Scalar step(Scalar dt)
+    {
+        update();
+        return limiter->step(dt);
+    }
+
+protected:
+    /**
+     * @brief  finds the junction speed of the first waypoint, going backwards from the first stop after it, and how far past the waypoint it can aim
+     */
+    void plan()
+    {
+        Scalar velLimit = limiter->getVelLimit();
+        Scalar decelLimit = limiter->getDecelLimit();
+        Scalar waypoint = waypoints[first];
+        Scalar direction = (waypoint > from) ? 1 : -1;
+
+        // the run of waypoints in the same direction, the last of them is stopped at
+        size_t run = 1;
+        Scalar last = waypoint;
+        while (run < count) {
+            Scalar next = waypoints[(first + run) % Capacity];
+            if (direction * (next - last) <= 0) {
+                break;
+            }
+            last = next;
+            run++;
+        }
+
+        Scalar speed = 0; // at waypoint run - 1
+        for (size_t i = run - 1; i > 0; i--) {
+            Scalar dist = abs(waypoints[(first + i) % Capacity] - waypoints[(first + i - 1) % Capacity]);
+            speed = min(velLimit, (Scalar)sqrt(sq(speed) + 2 * decelLimit * dist)); // v^2 = u^2 + 2as
+        }
+        junctionSpeed = speed;
+
+        runDistance = abs(last - waypoint);
+        if (decelLimit == INFINITY) {
+            brakingDistance = runDistance;
+        } else if (decelLimit == 0) {
+            brakingDistance = 0;
+        } else {
+            brakingDistance = min((Scalar)(sq(speed) / 2 / decelLimit), runDistance);
+        }
+        plannedVelLimit = velLimit;
+        plannedDecelLimit = decelLimit;
+        planned = true;
+    }
+
+    /**
+     * @brief  sets the target past the first waypoint, by the braking distance, or by a time interval at the junction speed if that's more
+     *         (if the step that passes the waypoint could also get to the target, the calculation would stop there instead of carrying on)
+     */
+    void aim()
+    {
+        Scalar waypoint = waypoints[first];
+        Scalar direction = (waypoint > from) ? 1 : -1;
+        Scalar beyond = min(max(brakingDistance, junctionSpeed * limiter->getTimeInterval()), runDistance);
+        Scalar target = waypoint + direction * beyond;
+        if (target != limiter->getTarget()) {
+            limiter->setTarget(target);
+        }
+    }
+};
+#endif